@@ -16,16 +16,72 @@ export interface SudokuWasmModule {
   _has_unique_sudoku_solution: (puzzlePtr: number, dim: number) => number;
   _get_sudoku_difficulty: (puzzlePtr: number, dim: number) => number;
   _generate_sudoku: (puzzlePtr: number, dim: number, difficulty: number) => number;
+  // 1바이트 셀 보드 N개를 한 번의 호출로 처리하는 일괄 API
+  _allocate_sudoku_boards: (dim: number, n: number) => number;
+  _free_sudoku_boards: (ptr: number) => void;
+  _solve_sudoku_boards: (puzzlesPtr: number, n: number, dim: number, solutionsPtr: number, numThreads: number) => number;
+  _validate_sudoku_boards: (boardsPtr: number, n: number, dim: number, resultsPtr: number) => number;
+  _count_sudoku_boards: (puzzlesPtr: number, n: number, dim: number, limit: number, countsPtr: number, numThreads: number) => number;
+  // 멀티스레드 빌드 전용 (numThreads가 0 이하이면 논리 코어 수만큼 사용)
+  _solve_sudoku_batch?: (puzzlesPtr: number, n: number, dim: number, solutionsPtr: number, numThreads: number) => number;
+  _count_sudoku_solutions_parallel?: (puzzlePtr: number, dim: number, limit: number, numThreads: number) => number;
+  _generate_sudoku_parallel?: (puzzlePtr: number, dim: number, difficulty: number, numThreads: number) => number;
+  _sudoku_thread_count?: () => number;
+  HEAPU8: Uint8Array;
+  HEAP32: Int32Array;
   HEAPU32: Uint32Array;
 }
 
+// 빌드 변형별 스크립트/바이너리 경로 (멀티스레드 빌드, SIMD128 빌드, 스칼라 빌드)
+const WASM_VARIANTS = {
+  threads: { script: '/sudoku-wasm-threads.js', binary: '/sudoku-wasm-threads.wasm' },
+  simd: { script: '/sudoku-wasm-simd.js', binary: '/sudoku-wasm-simd.wasm' },
+  scalar: { script: '/sudoku-wasm.js', binary: '/sudoku-wasm.wasm' },
+} as const;
+
+export type WasmVariant = keyof typeof WASM_VARIANTS;
+
+// SIMD128 명령어(i8x16.splat, i8x16.popcnt)를 쓰는 최소 WASM 모듈
+const SIMD_PROBE_MODULE = new Uint8Array([
+  0, 97, 115, 109, 1, 0, 0, 0, 1, 5, 1, 96, 0, 1, 123, 3, 2, 1, 0, 10, 10, 1, 8, 0, 65, 0, 253, 15, 253, 98, 11
+]);
+
 let wasmModule: SudokuWasmModule | null = null;
+let wasmVariant: WasmVariant | null = null;
 let isWasmLoaded = false;
 let loadPromise: Promise<SudokuWasmModule> | null = null;
 
+/**
+ * 브라우저의 WASM SIMD128 지원 여부 확인
+ * SIMD 명령어를 포함한 최소 모듈이 검증을 통과하는지로 판단
+ */
+export const isSimdSupported = (): boolean => {
+  try {
+    return typeof WebAssembly === 'object' && WebAssembly.validate(SIMD_PROBE_MODULE);
+  } catch {
+    return false;
+  }
+};
+
+/**
+ * 멀티스레드(pthreads) 빌드 사용 가능 여부 확인
+ * SharedArrayBuffer는 cross-origin isolation(COOP/COEP 헤더)이 적용된 페이지에서만 사용 가능
+ * 멀티스레드 빌드는 SIMD128도 사용하므로 SIMD 지원도 함께 확인
+ */
+export const isThreadsSupported = (): boolean => {
+  return typeof crossOriginIsolated !== 'undefined' && crossOriginIsolated &&
+    typeof SharedArrayBuffer !== 'undefined' && isSimdSupported();
+};
+
+/**
+ * 현재 로드된 WASM 빌드 변형 (로드 전에는 null)
+ */
+export const getWasmVariant = (): WasmVariant | null => wasmVariant;
+
 /**
  * WASM 모듈 로드 함수
  * 최초 호출 시 WASM 모듈을 로드하고, 이후 호출 시 캐시된 모듈 반환
+ * 멀티스레드 → SIMD → 스칼라 순서로 지원되는 빌드를 시도하고, 실패하면 다음 빌드로 대체
  */
 export const loadWasmModule = async (): Promise<SudokuWasmModule> => {
   if (isWasmLoaded && wasmModule) {
@@ -38,16 +94,45 @@ export const loadWasmModule = async (): Promise<SudokuWasmModule> => {
     return loadPromise;
   }
 
-  console.log('[WASM] Starting to load WASM module');
-  loadPromise = new Promise<SudokuWasmModule>((resolve, reject) => {
+  const candidates: WasmVariant[] = [];
+  if (isThreadsSupported()) candidates.push('threads');
+  if (isSimdSupported()) candidates.push('simd');
+  candidates.push('scalar');
+  console.log('[WASM] Starting to load WASM module, variant:', candidates[0]);
+
+  loadPromise = candidates.slice(1).reduce(
+    (promise, next) => promise.catch((error) => {
+      console.warn(`[WASM] Build failed to load, falling back to ${next}:`, error);
+      return loadWasmVariant(next);
+    }),
+    loadWasmVariant(candidates[0])
+  );
+
+  // 로드에 실패하면 다음 호출에서 다시 시도할 수 있도록 초기화
+  loadPromise.catch(() => {
+    loadPromise = null;
+  });
+
+  return loadPromise;
+};
+
+/**
+ * 지정한 빌드 변형의 스크립트를 추가하고 런타임 초기화를 기다림
+ */
+const loadWasmVariant = (variant: WasmVariant): Promise<SudokuWasmModule> => {
+  const { script: scriptPath, binary: binaryPath } = WASM_VARIANTS[variant];
+
+  return new Promise<SudokuWasmModule>((resolve, reject) => {
     try {
-      // WASM 모듈 중복 로드 방지를 위한 검사
-      const existingScript = document.querySelector('script[src="/sudoku-wasm.js"]');
-      if (existingScript) {
-        console.log('[WASM] Script already exists in the document');
-        // 기존 스크립트가 있으면 제거
-        existingScript.remove();
-      }
+      // WASM 모듈 중복 로드 방지를 위한 검사 (다른 변형의 스크립트도 제거)
+      Object.values(WASM_VARIANTS).forEach(({ script: path }) => {
+        const existingScript = document.querySelector(`script[src="${path}"]`);
+        if (existingScript) {
+          console.log('[WASM] Script already exists in the document:', path);
+          // 기존 스크립트가 있으면 제거
+          existingScript.remove();
+        }
+      });
       
       // 타임아웃 설정
       const timeout = setTimeout(() => {
@@ -64,11 +149,12 @@ export const loadWasmModule = async (): Promise<SudokuWasmModule> => {
           // @ts-ignore
           wasmModule = window.Module as SudokuWasmModule;
           if (wasmModule) {
-            console.log('[WASM] Module initialization complete');
+            console.log('[WASM] Module initialization complete, variant:', variant);
             const availableFunctions = Object.keys(wasmModule)
               .filter(key => key.startsWith('_'));
             console.log('[WASM] Available functions:', availableFunctions);
             
+            wasmVariant = variant;
             isWasmLoaded = true;
             resolve(wasmModule);
           } else {
@@ -77,6 +163,12 @@ export const loadWasmModule = async (): Promise<SudokuWasmModule> => {
             reject(error);
           }
         },
+        // 바이너리 로드/컴파일 실패 시 (예: SIMD 빌드가 배포되지 않은 경우)
+        onAbort: function(reason: unknown) {
+          console.error('[WASM] Runtime aborted:', reason);
+          clearTimeout(timeout);
+          reject(new Error(`WASM runtime aborted: ${reason}`));
+        },
         print: function(text: string) {
           console.log('[WASM stdout]', text);
         },
@@ -87,7 +179,10 @@ export const loadWasmModule = async (): Promise<SudokuWasmModule> => {
         locateFile: function(path: string) {
           console.log('[WASM] Locating file:', path);
           if (path.endsWith('.wasm')) {
-            return `/sudoku-wasm.wasm`; // 정확한 경로 지정
+            return binaryPath; // 정확한 경로 지정
+          }
+          if (path.endsWith('.worker.js')) {
+            return scriptPath.replace(/\.js$/, '.worker.js'); // 멀티스레드 빌드의 워커 스크립트
           }
           return path;
         }
@@ -95,7 +190,7 @@ export const loadWasmModule = async (): Promise<SudokuWasmModule> => {
       
       // 스크립트 요소 생성 및 추가
       const script = document.createElement('script');
-      script.src = '/sudoku-wasm.js';
+      script.src = scriptPath;
       script.async = true;
       
       script.onload = () => {
@@ -105,7 +200,7 @@ export const loadWasmModule = async (): Promise<SudokuWasmModule> => {
       script.onerror = (e) => {
         console.error('[WASM] Script loading error:', e);
         clearTimeout(timeout);
-        reject(new Error('Failed to load WASM module'));
+        reject(new Error(`Failed to load WASM module: ${scriptPath}`));
       };
       
       console.log('[WASM] Appending script to body');
@@ -116,12 +211,12 @@ export const loadWasmModule = async (): Promise<SudokuWasmModule> => {
       reject(error);
     }
   });
-
-  return loadPromise;
 };
 
 /**
- * 스도쿠 보드 배열을 WASM 메모리에 전달
+ * 스도쿠 보드 배열을 WASM 메모리에 전달 (int 셀)
+ * 셀마다 함수를 호출하지 않고 힙 뷰에 한 번에 복사
+ * 메모리가 늘어나면 힙 뷰가 교체되므로 뷰는 매번 모듈에서 새로 가져옴
  */
 export const setWasmSudokuBoard = (
   wasmModule: SudokuWasmModule, 
@@ -129,51 +224,93 @@ export const setWasmSudokuBoard = (
   dim: number = 9
 ): number => {
   const boardPtr = wasmModule._allocate_sudoku_array(dim);
+  const cells = Int32Array.from({ length: dim * dim }, (_, i) => board[i] || 0);
   
-  for (let i = 0; i < dim * dim; i++) {
-    wasmModule._set_sudoku_value(boardPtr, i, board[i] || 0);
-  }
+  wasmModule.HEAP32.set(cells, boardPtr >> 2);
   
   return boardPtr;
 };
 
 /**
- * WASM 메모리에서 스도쿠 보드 배열 가져오기
+ * WASM 메모리에서 스도쿠 보드 배열 가져오기 (int 셀)
  */
 export const getWasmSudokuBoard = (
   wasmModule: SudokuWasmModule, 
   boardPtr: number, 
   dim: number = 9
 ): number[] => {
-  const board: number[] = [];
+  const start = boardPtr >> 2;
+  return Array.from(wasmModule.HEAP32.subarray(start, start + dim * dim));
+};
+
+/**
+ * 여러 보드를 1바이트 셀로 이어 붙여 WASM 메모리에 전달
+ */
+const setWasmSudokuBoards = (
+  wasmModule: SudokuWasmModule, 
+  boards: number[][], 
+  dim: number = 9
+): number => {
+  const cellCount = dim * dim;
+  const boardsPtr = wasmModule._allocate_sudoku_boards(dim, boards.length);
+  const heap = wasmModule.HEAPU8;
   
-  for (let i = 0; i < dim * dim; i++) {
-    board.push(wasmModule._get_sudoku_value(boardPtr, i));
-  }
+  boards.forEach((board, k) => {
+    for (let i = 0; i < cellCount; i++) {
+      heap[boardsPtr + k * cellCount + i] = board[i] || 0;
+    }
+  });
   
-  return board;
+  return boardsPtr;
+};
+
+/**
+ * WASM 메모리의 1바이트 셀 보드 N개를 배열로 가져오기
+ */
+const getWasmSudokuBoards = (
+  wasmModule: SudokuWasmModule, 
+  boardsPtr: number, 
+  count: number, 
+  dim: number = 9
+): number[][] => {
+  const cellCount = dim * dim;
+  const heap = wasmModule.HEAPU8;
+  
+  return Array.from({ length: count }, (_, k) =>
+    Array.from(heap.subarray(boardsPtr + k * cellCount, boardsPtr + (k + 1) * cellCount))
+  );
 };
 
 /**
  * 스도쿠 퍼즐 풀기
  */
 export const solveSudoku = async (board: number[], dim: number = 9): Promise<number[] | null> => {
+  const [solution] = await solveSudokuBatch([board], dim);
+  return solution;
+};
+
+/**
+ * 여러 스도쿠 퍼즐을 한 번의 호출로 풀기
+ * 풀 수 없는 퍼즐 자리에는 null 반환
+ */
+export const solveSudokuBatch = async (boards: number[][], dim: number = 9): Promise<(number[] | null)[]> => {
+  if (boards.length === 0) return [];
+  
   const wasm = await loadWasmModule();
   
-  const puzzlePtr = setWasmSudokuBoard(wasm, board, dim);
-  const solutionPtr = wasm._allocate_sudoku_array(dim);
+  const puzzlesPtr = setWasmSudokuBoards(wasm, boards, dim);
+  const solutionsPtr = wasm._allocate_sudoku_boards(dim, boards.length);
   
-  const result = wasm._solve_sudoku(puzzlePtr, dim, solutionPtr);
+  // 풀 수 없는 보드의 솔루션은 0으로 채워짐 (멀티스레드 빌드에서는 코어 수만큼 병렬 처리)
+  wasm._solve_sudoku_boards(puzzlesPtr, boards.length, dim, solutionsPtr, 0);
   
-  let solution: number[] | null = null;
-  if (result === 1) {
-    solution = getWasmSudokuBoard(wasm, solutionPtr, dim);
-  }
+  const solutions = getWasmSudokuBoards(wasm, solutionsPtr, boards.length, dim)
+    .map(solution => (solution[0] === 0 ? null : solution));
   
-  wasm._free_sudoku_array(puzzlePtr);
-  wasm._free_sudoku_array(solutionPtr);
+  wasm._free_sudoku_boards(puzzlesPtr);
+  wasm._free_sudoku_boards(solutionsPtr);
   
-  return solution;
+  return solutions;
 };
 
 /**
@@ -253,7 +390,10 @@ export const generateSudoku = async (dim: number = 9, difficulty: number = 2): P
     }
     
     console.log('[generateSudoku] 스도쿠 생성 시작');
-    const result = wasm._generate_sudoku(puzzlePtr, dim, difficulty);
+    // 멀티스레드 빌드에서는 칸 제거 후보를 워커 풀에서 병렬로 검사
+    const result = wasmVariant === 'threads' && wasm._generate_sudoku_parallel
+      ? wasm._generate_sudoku_parallel(puzzlePtr, dim, difficulty, 0)
+      : wasm._generate_sudoku(puzzlePtr, dim, difficulty);
     console.log('[generateSudoku] 생성 결과=', result);
     
     let puzzle: number[] | null = null;
@@ -284,11 +424,13 @@ export const generateSudoku = async (dim: number = 9, difficulty: number = 2): P
 export const validateSudoku = async (solution: number[], dim: number = 9): Promise<boolean> => {
   const wasm = await loadWasmModule();
   
-  const solutionPtr = setWasmSudokuBoard(wasm, solution, dim);
+  const solutionPtr = setWasmSudokuBoards(wasm, [solution], dim);
+  const resultPtr = wasm._malloc(1);
   
-  const result = wasm._validate_sudoku(solutionPtr, dim);
+  const result = wasm._validate_sudoku_boards(solutionPtr, 1, dim, resultPtr);
   
-  wasm._free_sudoku_array(solutionPtr);
+  wasm._free_sudoku_boards(solutionPtr);
+  wasm._free(resultPtr);
   
   return result === 1;
 };
@@ -1,62 +1,98 @@
 #include <assert.h>
+#include <stdlib.h>
 #include <string.h>
 #include "dlinks_matrix.h"
 
-// 메모리 풀 정의
-static unsigned char memory_pool[MEMORY_POOL_SIZE];     // 고정 크기 메모리 풀 (약 168KB)
-static bool memory_pool_used[MAX_NODES];                // 사용 여부 플래그
-static int memory_pool_next = 0;                        // 다음 할당 위치
-static int memory_error = 0;                            // 메모리 에러 플래그
+static node_chunk* next_chunk(SolverContext* ctx);
 
-void init_memory_pool(void) {
-    memset(memory_pool_used, 0, sizeof(memory_pool_used));
-    memory_pool_next = 0;
-    memory_error = 0;
+SolverContext* create_solver_context(void) {
+    SolverContext* ctx = (SolverContext*)calloc(1, sizeof(SolverContext));
+    if (!ctx) return NULL;
+    reset_solver_context(ctx);
+    return ctx;
 }
 
-void reset_memory_pool(void) {
-    memset(memory_pool_used, 0, sizeof(memory_pool_used));
-    memory_pool_next = 0;
-    memory_error = 0;
+void reset_solver_context(SolverContext* ctx) {
+    init_memory_pool(ctx);
+    reset_stack(&ctx->solution);
+    reset_search_stack(&ctx->search);
+    if (ctx->solution_buffer) {
+        memset(ctx->solution_buffer, 0, ctx->solution_capacity * sizeof(int));
+    }
 }
 
-Node* alloc_node(void) {
-    while (memory_pool_next < MAX_NODES && memory_pool_used[memory_pool_next]) {
-        memory_pool_next++;
+void destroy_solver_context(SolverContext* ctx) {
+    if (!ctx) return;
+    node_chunk* chunk = ctx->first_chunk;
+    while (chunk) {
+        node_chunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
     }
-    if (memory_pool_next >= MAX_NODES) {
-        memory_error = 1; // 메모리 초과 에러
-        return NULL;
+    free(ctx->headers);
+    free(ctx->solution_buffer);
+    free(ctx);
+}
+
+void init_memory_pool(SolverContext* ctx) {
+    ctx->current_chunk = NULL;
+    ctx->memory_error = 0;
+}
+
+// 청크는 해제하지 않고 처음부터 다시 사용 (O(1))
+void reset_memory_pool(SolverContext* ctx) {
+    ctx->current_chunk = NULL;
+    ctx->memory_error = 0;
+}
+
+Node* alloc_node(SolverContext* ctx) {
+    node_chunk* chunk = ctx->current_chunk;
+    if (!chunk || chunk->used == NODE_CHUNK_SIZE) {
+        chunk = next_chunk(ctx);
+        if (!chunk) {
+            ctx->memory_error = 1; // 메모리 초과 에러
+            return NULL;
+        }
+    }
+    return &chunk->nodes[chunk->used++];
+}
+
+// 가장 최근에 할당한 노드만 즉시 반환, 나머지는 풀 리셋 때 한꺼번에 회수
+void free_node(SolverContext* ctx, Node* node) {
+    node_chunk* chunk = ctx->current_chunk;
+    if (node && chunk && chunk->used > 0 && node == &chunk->nodes[chunk->used - 1]) {
+        chunk->used--;
     }
-    int index = memory_pool_next;
-    memory_pool_used[index] = true;
-    memory_pool_next++;
-    Node* node = (Node*)(memory_pool + index * NODE_SIZE);
-    node->pool_index = index;
-    node->is_used = true;
-    return node;
 }
 
-void free_node(Node* node) {
-    if (node && node->is_used) {
-        memory_pool_used[node->pool_index] = false;
-        node->is_used = false;
-        if (node->pool_index < memory_pool_next) {
-            memory_pool_next = node->pool_index;
+// 다음 청크로 넘어감: 이전에 할당한 청크가 있으면 재사용하고 없으면 새로 할당
+static node_chunk* next_chunk(SolverContext* ctx) {
+    node_chunk* next = ctx->current_chunk ? ctx->current_chunk->next : ctx->first_chunk;
+    if (!next) {
+        next = (node_chunk*)malloc(sizeof(node_chunk));
+        if (!next) return NULL;
+        next->next = NULL;
+        if (ctx->current_chunk) {
+            ctx->current_chunk->next = next;
+        } else {
+            ctx->first_chunk = next;
         }
     }
+    next->used = 0;
+    ctx->current_chunk = next;
+    return next;
 }
 
-int get_memory_error(void) {
-    return memory_error;
+int get_memory_error(SolverContext* ctx) {
+    return ctx->memory_error;
 }
 
-void clear_memory_error(void) {
-    memory_error = 0;
+void clear_memory_error(SolverContext* ctx) {
+    ctx->memory_error = 0;
 }
 
 void init_matrix(Matrix* mx) {
-    Node* root = alloc_node();
+    Node* root = alloc_node(mx->context);
     if (!root) return;
     root->row = -1;
     root->col = -1;
@@ -67,7 +103,7 @@ void init_matrix(Matrix* mx) {
     mx->root = root;
 
     for (int i =0; i < mx->num_rows; i++) {
-        Node* node = alloc_node();
+        Node* node = alloc_node(mx->context);
         if (!node) return;
         node->row = i;
         node->col = -1;
@@ -84,10 +120,11 @@ void init_matrix(Matrix* mx) {
         }
     }
     mx->root->up = mx->rows[mx->num_rows - 1];
+    mx->root->down = mx->rows[0];
     mx->rows[mx->num_rows - 1]->down = mx->root;
 
     for (int i = 0; i < mx->num_cols; i++) {
-        Node* node = alloc_node();
+        Node* node = alloc_node(mx->context);
         if (!node) return;
         node->row = -1;
         node->col = i;
@@ -105,23 +142,39 @@ void init_matrix(Matrix* mx) {
 
     }
     mx->root->left = mx->cols[mx->num_cols - 1];
+    mx->root->right = mx->cols[0];
     mx->cols[mx->num_cols - 1]->right = mx->root;
     mx->root->count = 0;
 }
 
-Matrix* create_matrix(int num_rows, int num_cols) {
-    static Matrix mx;   // 정적 Matrix 구조체
-    mx.num_rows = num_rows;
-    mx.num_cols = num_cols;
-    mx.solution = create_stack();
-    mx.solved = false;
-    init_matrix(&mx);
-    return &mx;
+Matrix* create_matrix(SolverContext* ctx, int num_rows, int num_cols) {
+    Matrix* mx = &ctx->matrix;  // 컨텍스트가 소유한 Matrix 구조체
+    mx->num_rows = num_rows;
+    mx->num_cols = num_cols;
+    mx->solution = create_stack(ctx);
+    mx->context = ctx;
+    mx->solved = false;
+
+    // 헤더 배열은 더 큰 행렬이 필요할 때만 늘림
+    if (num_rows + num_cols > ctx->header_capacity) {
+        Node** headers = (Node**)realloc(ctx->headers, (num_rows + num_cols) * sizeof(Node*));
+        if (!headers) {
+            ctx->memory_error = 1;
+            return mx;
+        }
+        ctx->headers = headers;
+        ctx->header_capacity = num_rows + num_cols;
+    }
+    mx->rows = ctx->headers;
+    mx->cols = ctx->headers + num_rows;
+
+    init_matrix(mx);
+    return mx;
 }
 
 void insert_node(Matrix* mx, int row, int col, int value) {
     assert(row >= 0 && col >= 0 && row < mx->num_rows && col < mx->num_cols);
-    Node* new_node = alloc_node();
+    Node* new_node = alloc_node(mx->context);
     if (!new_node) {
         return; // 메모리 초과 시 무시 (상위 단에서 에러 처리)
     }
@@ -139,7 +192,7 @@ void insert_node(Matrix* mx, int row, int col, int value) {
     }
     if (itr->right->col == col) {
         itr->right->value = value;
-        free_node(new_node);
+        free_node(mx->context, new_node);
         return;
     }
     new_node->right = itr->right;
@@ -177,12 +230,12 @@ void remove_node(Matrix* mx, int row, int col) {
     itr->down->up = itr->up;
     mx->rows[row]->count--;
     mx->cols[col]->count--;
-    free_node(itr);
+    free_node(mx->context, itr);
 }
 
 void delete_matrix(Matrix* mx) {
     reset_stack(mx->solution);
-    reset_memory_pool(); // 모든 노드 해제 대신 메모리 풀 리셋
+    reset_memory_pool(mx->context); // 모든 노드 해제 대신 메모리 풀 리셋
 }
 
 
@@ -209,6 +262,7 @@ void cover(Node* n) {
     col->left->right = col->right;
     for (Node* vert_itr = col->down; vert_itr != col; vert_itr = vert_itr->down) {
         for (Node* horiz_itr = vert_itr->right; horiz_itr != vert_itr; horiz_itr = horiz_itr->right) {
+            if (horiz_itr->col < 0) continue; // 행 헤더는 열에 속하지 않음
             horiz_itr->up->down = horiz_itr->down;
             horiz_itr->down->up = horiz_itr->up;
             column_of(horiz_itr)->count--;
@@ -220,6 +274,7 @@ void uncover(Node* n) {
     Node* col = column_of(n);
     for (Node* vert_itr = col->up; vert_itr != col; vert_itr = vert_itr->up) {
         for (Node* horiz_itr = vert_itr->left; horiz_itr != vert_itr; horiz_itr = horiz_itr->left) {
+            if (horiz_itr->col < 0) continue;
             horiz_itr->up->down = horiz_itr;
             horiz_itr->down->up = horiz_itr;
             column_of(horiz_itr)->count++;
@@ -229,6 +284,51 @@ void uncover(Node* n) {
     col->left->right = col;
 }
 
+// 행의 모든 열을 덮음 (행 헤더 노드는 열이 없으므로 제외)
+static void cover_row(Node* row_node) {
+    Node* horiz_itr = row_node;
+    do {
+        if (horiz_itr->col >= 0) {
+            cover(horiz_itr);
+        }
+    } while ((horiz_itr = horiz_itr->right) != row_node);
+}
+
+// cover_row의 역순으로 열을 되돌림
+static void uncover_row(Node* row_node) {
+    Node* horiz_itr = row_node;
+    do {
+        horiz_itr = horiz_itr->left;
+        if (horiz_itr->col >= 0) {
+            uncover(horiz_itr);
+        }
+    } while (horiz_itr != row_node);
+}
+
+// 탐색 단계 하나를 진행: 이 단계에서 고른 행을 되돌리고 다음 후보 행을 덮음
+// 후보가 남아 있지 않으면 단계를 스택에서 꺼내고 false 반환
+static bool advance_search_state(Matrix* matrix, search_stack* search_stack) {
+    search_state* current_state = &search_stack->states[search_stack->top];
+    Node* selected_col = current_state->selected_col;
+
+    if (current_state->current_row == NULL) {
+        current_state->current_row = selected_col->down;
+    } else {
+        uncover_row(current_state->current_row);
+        pop_stack(matrix->solution);
+        current_state->current_row = current_state->current_row->down;
+    }
+
+    if (current_state->current_row == selected_col) {
+        pop_search_stack(search_stack);
+        return false;
+    }
+
+    push_stack(matrix->solution, matrix->rows[current_state->current_row->row]);
+    cover_row(current_state->current_row);
+    return true;
+}
+
 bool alg_x_search_iterative(Matrix* matrix, int max_iterations, int* iterations_done) {
     if (matrix_is_empty(matrix)) {
         matrix->solved = true;
@@ -236,57 +336,21 @@ bool alg_x_search_iterative(Matrix* matrix, int max_iterations, int* iterations_
         return true;
     }
 
-    search_stack* search_stack = create_search_stack();
+    search_stack* search_stack = create_search_stack(matrix->context);
     int iteration_count = 0;
 
     search_state initial_state = {
         .selected_col = select_min_column(matrix),
-        .current_row = NULL,
-        .is_backtracking = false
+        .current_row = NULL
     };
     push_search_stack(search_stack, initial_state);
 
     while (search_stack->top >= 0 && iteration_count < max_iterations) {
         iteration_count++;
-        search_state* current_state = &search_stack->states[search_stack->top];
-
-        Node* selected_col = current_state->selected_col;
-        if (selected_col->count < 1) {
-            pop_search_stack(search_stack);
-            continue;
-        }
-
-        if (current_state->current_row == NULL) {
-            current_state->current_row = selected_col->down;
-        } else if (!current_state->is_backtracking) {
-            current_state->current_row = current_state->current_row->down;
-        }
-
-        if (current_state->current_row == selected_col) {
-            current_state->is_backtracking = true;
-            if (search_stack->top > 0) {
-                Node* row_to_uncover = matrix->solution->items[matrix->solution->top - 1];
-                Node* horiz_itr = row_to_uncover;
-                do {
-                    if (horiz_itr->col >= 0) {
-                        uncover(horiz_itr);
-                    }
-                } while ((horiz_itr = horiz_itr->right) != row_to_uncover);
-                pop_stack(matrix->solution);
-            }
-            pop_search_stack(search_stack);
+        if (!advance_search_state(matrix, search_stack)) {
             continue;
         }
 
-        Node* vert_itr = current_state->current_row;
-        push_stack(matrix->solution, matrix->rows[vert_itr->row]);
-        Node* horiz_itr = vert_itr;
-        do {
-            if (horiz_itr->col >= 0) {
-                cover(horiz_itr);
-            }
-        } while ((horiz_itr = horiz_itr->right) != vert_itr);
-
         if (matrix_is_empty(matrix)) {
             matrix->solved = true;
             *iterations_done = iteration_count;
@@ -295,8 +359,7 @@ bool alg_x_search_iterative(Matrix* matrix, int max_iterations, int* iterations_
 
         search_state next_state = {
             .selected_col = select_min_column(matrix),
-            .current_row = NULL,
-            .is_backtracking = false
+            .current_row = NULL
         };
         push_search_stack(search_stack, next_state);
     }
@@ -313,74 +376,28 @@ bool alg_x_count_solutions(Matrix* matrix, int max_iterations, int* solution_cou
         return false; // 게속 다른 해를 찾기 위해 false 반환
     }
 
-    search_stack* search_stack = create_search_stack();
+    search_stack* search_stack = create_search_stack(matrix->context);
     int iteration_count = 0;
 
     search_state initial_state = {
         .selected_col = select_min_column(matrix),
-        .current_row = NULL,
-        .is_backtracking = false
+        .current_row = NULL
     };
     push_search_stack(search_stack, initial_state);
 
     while (search_stack->top >= 0 && iteration_count < max_iterations && *solution_count < 2) {
         iteration_count++;
-        search_state* current_state = &search_stack->states[search_stack->top];
-
-        Node* selected_col = current_state->selected_col;
-        if (selected_col->count < 1) {
-            pop_search_stack(search_stack);
-            continue;
-        }
-
-        if (current_state->current_row == NULL) {
-            current_state->current_row = selected_col->down;
-        } else if (!current_state->is_backtracking) {
-            current_state->current_row = current_state->current_row->down;
-        }
-
-        if (current_state->current_row == selected_col) {
-            current_state->is_backtracking = true;
-            if (search_stack->top > 0) {
-                Node* row_to_uncover = matrix->solution->items[matrix->solution->top -1];
-                Node* horiz_itr = row_to_uncover;
-                do {
-                    if (horiz_itr->col >= 0) {
-                        uncover(horiz_itr);
-                    }
-                } while ((horiz_itr = horiz_itr->right) != row_to_uncover);
-                pop_stack(matrix->solution);
-            }
-            pop_search_stack(search_stack);
+        if (!advance_search_state(matrix, search_stack)) {
             continue;
         }
 
-        Node* vert_itr = current_state->current_row;
-        push_stack(matrix->solution, matrix->rows[vert_itr->row]);
-        Node* horiz_itr = vert_itr;
-        do {
-            if (horiz_itr->col >= 0) {
-                cover(horiz_itr);
-            }
-        } while ((horiz_itr = horiz_itr->right) != vert_itr);
-
         if (matrix_is_empty(matrix)) {
+            // 해를 하나 셌으면 같은 단계의 다음 후보로 진행
             (*solution_count)++;
-            if (*solution_count >= 2) {
-                return true;
-            }
-            horiz_itr = vert_itr->left;
-            do {
-                if (horiz_itr->col >= 0) {
-                    uncover(horiz_itr);
-                }
-            } while ((horiz_itr = horiz_itr->left) != vert_itr);
-            pop_stack(matrix->solution);
         } else {
             search_state next_state = {
                 .selected_col = select_min_column(matrix),
-                .current_row = NULL,
-                .is_backtracking = false
+                .current_row = NULL
             };
             push_search_stack(search_stack, next_state);
         }
@@ -389,10 +406,9 @@ bool alg_x_count_solutions(Matrix* matrix, int max_iterations, int* solution_cou
     return *solution_count >= 2;
 }
 
-solution_stack* create_stack(void) {
-    static solution_stack stack;
-    stack.top = 0;
-    return &stack;
+solution_stack* create_stack(SolverContext* ctx) {
+    ctx->solution.top = 0;
+    return &ctx->solution;
 }
 
 void push_stack(solution_stack* stack, Node* data) {
@@ -412,10 +428,9 @@ void reset_stack(solution_stack* stack) {
     stack->top = 0;
 }
 
-search_stack* create_search_stack(void) {
-    static search_stack stack;
-    stack.top = -1;
-    return &stack;
+search_stack* create_search_stack(SolverContext* ctx) {
+    ctx->search.top = -1;
+    return &ctx->search;
 }
 
 void push_search_stack(search_stack* stack, search_state state) {
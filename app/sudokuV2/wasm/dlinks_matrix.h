@@ -4,12 +4,8 @@
 
 #define uln "\033[4m"
 #define res "\033[0m"
-#define DIM 9
-#define GRID_SIZE (DIM * DIM)
-#define MAX_NODES 4200 // 최악의 경우 (3970) 대비 약 5% 여유
-#define MAX_STACK_SIZE 2000
-#define NODE_SIZE sizeof(Node)
-#define MEMORY_POOL_SIZE (MAX_NODES * NODE_SIZE) // 약 168 KB
+#define MAX_STACK_SIZE 2401 // 49x49 보드의 셀 수 (해답 깊이는 셀 수를 넘지 않음)
+#define NODE_CHUNK_SIZE 1024 // 청크당 노드 수 (9x9 빈 퍼즐은 3970개로 4청크)
 
 // Toroidal Matrix structure used for holding the constraints of an exact cover problem
 typedef struct _matrix Matrix;
@@ -17,23 +13,24 @@ typedef struct _node Node;
 typedef struct _solution_stack solution_stack;
 typedef struct _search_state search_state;
 typedef struct _search_stack search_stack;
+typedef struct _solver_context SolverContext;
+typedef struct _node_chunk node_chunk;
 
 // Data node for sparse matrix
 struct _node {
     int row, col, value, type, count;
     Node* up, *down, *left, *right;
     Matrix* matrix;
-    int pool_index; // 메모리 풀 내 위치
-    bool is_used;   // 사용 여부 플래그
 };
 
 // Toroidally linked sparse matrix
 struct _matrix {
-    Node* rows[DIM * DIM * DIM];    // 9 x 9 x 9 = 729
-    Node* cols[DIM * DIM * 4];      // 9 x 9 x 4 = 324
+    Node** rows;                    // 행 헤더 (9 x 9 x 9 = 729)
+    Node** cols;                    // 열 헤더 (9 x 9 x 4 = 324)
     Node* root;
     int num_rows, num_cols;
     solution_stack* solution;
+    SolverContext* context;         // 노드를 할당하는 컨텍스트
     bool solved;
 };
 
@@ -46,8 +43,7 @@ struct _solution_stack {
 // State structure for iterative Algorithm x
 struct _search_state {
     Node* selected_col;
-    Node* current_row;
-    bool is_backtracking;
+    Node* current_row;      // 이 단계에서 덮은 행 (아직 고르지 않았으면 NULL)
 };
 
 // Stack for search states (array-based)
@@ -56,8 +52,35 @@ struct _search_stack {
     int top;
 };
 
+// Fixed-size block of nodes handed out in order by the bump allocator
+struct _node_chunk {
+    node_chunk* next;
+    int used;                           // 할당한 노드 수
+    Node nodes[NODE_CHUNK_SIZE];
+};
+
+// Solver state owned by one solve at a time (메모리 풀, 스택, 결과 버퍼)
+// 전역 상태가 없으므로 컨텍스트가 다르면 여러 풀이를 동시에 또는 중첩해서 실행 가능
+struct _solver_context {
+    node_chunk* first_chunk;            // 할당한 청크 목록 (컨텍스트 해제 전까지 재사용)
+    node_chunk* current_chunk;          // 할당 중인 청크 (리셋 직후에는 NULL)
+    int memory_error;                   // 메모리 에러 플래그
+    Node** headers;                     // 행 헤더 num_rows개 뒤에 열 헤더 num_cols개
+    int header_capacity;
+    Matrix matrix;
+    solution_stack solution;
+    search_stack search;
+    int* solution_buffer;               // 해답 출력 버퍼
+    int solution_capacity;
+};
+
+// Solver context management
+SolverContext* create_solver_context(void);
+void reset_solver_context(SolverContext* ctx);
+void destroy_solver_context(SolverContext* ctx);
+
 // Function declarations
-Matrix* create_matrix(int num_rows, int num_cols);
+Matrix* create_matrix(SolverContext* ctx, int num_rows, int num_cols);
 void insert_node(Matrix* mx, int row, int col, int value);
 void remove_node(Matrix* mx, int row, int col);
 void delete_matrix(Matrix* mx);
@@ -65,11 +88,11 @@ bool alg_x_search_iterative(Matrix* mx, int max_iterations, int* iterations_done
 bool alg_x_count_solutions(Matrix* mx, int max_iterations, int* solution_count);
 void cover(Node* n);
 void uncover(Node* n);
-solution_stack* create_stack(void);
+solution_stack* create_stack(SolverContext* ctx);
 void push_stack(solution_stack* stack, Node* data);
 void pop_stack(solution_stack* stack);
 void reset_stack(solution_stack* stack);
-search_stack* create_search_stack(void);
+search_stack* create_search_stack(SolverContext* ctx);
 void push_search_stack(search_stack* stack, search_state state);
 search_state* pop_search_stack(search_stack* stack);
 void reset_search_stack(search_stack* stack);
@@ -77,12 +100,12 @@ Node* select_min_column(Matrix* matrix);
 
 
 // Memory Pool Management
-void init_memory_pool(void);
-Node* alloc_node(void);
-void free_node(Node* node);
-void reset_memory_pool(void);
-int get_memory_error(void);
-void clear_memory_error(void);
+void init_memory_pool(SolverContext* ctx);
+Node* alloc_node(SolverContext* ctx);
+void free_node(SolverContext* ctx, Node* node);
+void reset_memory_pool(SolverContext* ctx);
+int get_memory_error(SolverContext* ctx);
+void clear_memory_error(SolverContext* ctx);
 
 static inline bool matrix_is_empty(Matrix* matrix) {
     return matrix->root->right == matrix->root;
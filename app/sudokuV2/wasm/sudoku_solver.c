@@ -1,11 +1,19 @@
-#include <assert.h>
 #include <math.h>
+#include <stdlib.h>
 #include <emscripten.h>
 #include "sudoku_solver.h"
 #include "dlinks_matrix.h"
 
-// 정적 버퍼를 사용하여 해답 저장
-static int solution_buffer[GRID_SIZE];
+// 기존 API(solve_sudoku, has_unique_solution)가 공유하는 기본 컨텍스트
+// 새 코드는 호출마다 자신의 컨텍스트를 넘기는 *_ctx 함수를 사용
+static SolverContext* default_context = NULL;
+
+static SolverContext* get_default_context(void) {
+    if (!default_context) {
+        default_context = create_solver_context();
+    }
+    return default_context;
+}
 
 static inline int one_constraint(int row, int dim) {
     return row / dim;
@@ -23,15 +31,27 @@ static inline int box_constraint(int row, int dim) {
     return 3 * (dim * dim) + (row / ((int)sqrt(dim) * dim * dim)) * (dim * (int)sqrt(dim)) + ((row / ((int)sqrt(dim) * dim)) % (int)sqrt(dim)) * dim + (row % dim);
 }
 
-Matrix* puzzle_to_matrix(int* sudoku_list, int dim) {
-    assert(dim == DIM);
+// 셀 수로 차원 계산: 4x4, 9x9, 16x16, 25x25 등 상자가 정사각형인 보드만 지원 (아니면 0)
+static int dim_from_length(int length) {
+    int dim = (int)(sqrt(length) + 0.5);
+    int box = (int)(sqrt(dim) + 0.5);
+    if (dim < 1 || dim * dim != length || box * box != dim || length > MAX_STACK_SIZE) {
+        return 0;
+    }
+    return dim;
+}
+
+Matrix* puzzle_to_matrix(SolverContext* ctx, int* sudoku_list, int dim) {
     int num_rows = dim * dim * dim;     // 729 for 9 x 9
     int num_cols = dim * dim * 4;       // 324 for 9 x 9
     int num_cells = dim * dim;          // 81 for 9 x 9
-    Matrix* matrix = create_matrix(num_rows, num_cols);
+    Matrix* matrix = create_matrix(ctx, num_rows, num_cols);
 
     int row = 0;
     for (int i = 0; i < num_cells; i++) {
+        if (get_memory_error(ctx)) {
+            break; // 헤더가 없는 행렬에 노드를 넣지 않도록 중단
+        }
         if (sudoku_list[i] == 0 ) {
             for (int j = 0; j < dim; j++) {
                 row = i * dim + j;
@@ -52,20 +72,42 @@ Matrix* puzzle_to_matrix(int* sudoku_list, int dim) {
 }
 
 EMSCRIPTEN_KEEPALIVE
-int* solve_sudoku(int* puzzle, int length) {
-    assert(length == GRID_SIZE);
-    // 정적 버퍼 초기화
-    for (int i = 0; i < GRID_SIZE; i++) {
-        solution_buffer[i] = 0;
-    }
+SolverContext* create_context(void) {
+    return create_solver_context();
+}
 
-    // 메모리 풀 초기화
-    init_memory_pool();
+EMSCRIPTEN_KEEPALIVE
+void reset_context(SolverContext* ctx) {
+    reset_solver_context(ctx);
+}
+
+EMSCRIPTEN_KEEPALIVE
+void destroy_context(SolverContext* ctx) {
+    destroy_solver_context(ctx);
+}
 
-    Matrix* matrix = puzzle_to_matrix(puzzle, DIM);
-    if (get_memory_error()) {
+EMSCRIPTEN_KEEPALIVE
+int* solve_sudoku_ctx(SolverContext* ctx, int* puzzle, int length) {
+    int dim = dim_from_length(length);
+    if (dim == 0) {
+        return NULL; // 지원하지 않는 보드 크기
+    }
+    // 해답 버퍼는 더 큰 보드가 들어올 때만 늘림
+    if (length > ctx->solution_capacity) {
+        int* buffer = (int*)realloc(ctx->solution_buffer, length * sizeof(int));
+        if (!buffer) {
+            return NULL;
+        }
+        ctx->solution_buffer = buffer;
+        ctx->solution_capacity = length;
+    }
+    // 컨텍스트의 해답 버퍼와 메모리 풀 초기화
+    reset_solver_context(ctx);
+
+    Matrix* matrix = puzzle_to_matrix(ctx, puzzle, dim);
+    if (get_memory_error(ctx)) {
         delete_matrix(matrix);
-        return solution_buffer; // 에러 발생 시 빈 결과 반환
+        return ctx->solution_buffer; // 에러 발생 시 빈 결과 반환
     }
     int iterations_done = 0;
     int max_iterations = 30000; // 넉넉하게
@@ -74,31 +116,51 @@ int* solve_sudoku(int* puzzle, int length) {
         int index, value;
         for (int i = 0; i < matrix->solution->top; i++) {
             Node* node = matrix->solution->items[i];
-            index = node->row / DIM;
-            value = (node->row % DIM) + 1;
-            solution_buffer[index] = value;
+            index = node->row / dim;
+            value = (node->row % dim) + 1;
+            ctx->solution_buffer[index] = value;
         }
     }
     delete_matrix(matrix);
-    return solution_buffer; // 정적 버퍼 반환, 메모리 해제 불필요
+    return ctx->solution_buffer; // 컨텍스트 버퍼 반환, 컨텍스트를 해제하기 전까지 유효
 }
 
 EMSCRIPTEN_KEEPALIVE
-int has_unique_solution(int* puzzle, int length) {
-    assert(length == GRID_SIZE);
+int count_solutions_ctx(SolverContext* ctx, int* puzzle, int length) {
+    int dim = dim_from_length(length);
+    if (dim == 0) {
+        return 0; // 지원하지 않는 보드 크기
+    }
     // 메모리 풀 초기화
-    init_memory_pool();
+    reset_solver_context(ctx);
 
-    Matrix* matrix = puzzle_to_matrix(puzzle, DIM);
-    if (get_memory_error()) {
+    Matrix* matrix = puzzle_to_matrix(ctx, puzzle, dim);
+    if (get_memory_error(ctx)) {
         delete_matrix(matrix);
-        return 0; // 에러 발생 시 유일하지 않음으로 처리
+        return 0; // 에러 발생 시 해 없음으로 처리
     }
     int solution_count = 0;
     int max_iterations = 30000; // 유일성 확인에도 동일한 제한
-    bool stop_search = alg_x_count_solutions(matrix, max_iterations, &solution_count);
+    alg_x_count_solutions(matrix, max_iterations, &solution_count);
     delete_matrix(matrix);
-    return (solution_count == 1) ? 1 : 0;
+    return solution_count; // 두 번째 해에서 멈추므로 최대 2
+}
+
+EMSCRIPTEN_KEEPALIVE
+int has_unique_solution_ctx(SolverContext* ctx, int* puzzle, int length) {
+    return (count_solutions_ctx(ctx, puzzle, length) == 1) ? 1 : 0;
 }
 
+EMSCRIPTEN_KEEPALIVE
+int* solve_sudoku(int* puzzle, int length) {
+    SolverContext* ctx = get_default_context();
+    if (!ctx) return NULL;
+    return solve_sudoku_ctx(ctx, puzzle, length);
+}
 
+EMSCRIPTEN_KEEPALIVE
+int has_unique_solution(int* puzzle, int length) {
+    SolverContext* ctx = get_default_context();
+    if (!ctx) return 0;
+    return has_unique_solution_ctx(ctx, puzzle, length);
+}
@@ -1,12 +1,22 @@
 #ifndef SUDOKU_SOLVER_H
 #define SUDOKU_SOLVER_H
 #include <emscripten/emscripten.h>
-
-#define DIM 9
-#define GRID_SIZE (DIM * DIM)
+#include "dlinks_matrix.h"
 
 // Function declarations for WASM export
 
+// 풀이 컨텍스트: 호출마다 자신의 메모리 풀과 스택을 쓰므로 서로 간섭하지 않음
+extern EMSCRIPTEN_KEEPALIVE SolverContext* create_context(void);
+extern EMSCRIPTEN_KEEPALIVE void reset_context(SolverContext* ctx);
+extern EMSCRIPTEN_KEEPALIVE void destroy_context(SolverContext* ctx);
+
+// length는 보드의 셀 수 (81, 256, 625 ...), 지원하지 않는 크기면 solve는 NULL, count는 0 반환
+extern EMSCRIPTEN_KEEPALIVE int* solve_sudoku_ctx(SolverContext* ctx, int* puzzle, int length);
+extern EMSCRIPTEN_KEEPALIVE int count_solutions_ctx(SolverContext* ctx, int* puzzle, int length);
+extern EMSCRIPTEN_KEEPALIVE int has_unique_solution_ctx(SolverContext* ctx, int* puzzle, int length);
+
+// 기존 API: 모듈의 기본 컨텍스트 하나를 공유
+
 extern EMSCRIPTEN_KEEPALIVE int* solve_sudoku(int* puzzle, int length);
 
 
@@ -0,0 +1,369 @@
+/**
+ * @file sudoku_bench.c
+ * @brief End-to-end solver benchmark over puzzle datasets
+ *
+ * Usage: sudoku_bench [-r repetitions] dataset...
+ *
+ * Each dataset is a file in the format of puzzle_format.h, all puzzles of
+ * one dimension. Every puzzle is solved with solve_puzzle, timed one call at
+ * a time, and its solution checked. The results are printed to stdout as
+ * JSON: per dataset the puzzles per second, mean, p50, p99 and max latency
+ * in microseconds, the peak resident memory so far and the matrix heap
+ * allocations per solve: heap_blocks, the blocks the matrices of either
+ * engine really took, next to nodes, which the per-node allocator used
+ * before the node arena took one heap block each for. Each dataset also reports how many of its
+ * puzzles have a unique solution, counted outside the timing, since the
+ * random_holes sets are cut from solved grids without a uniqueness check.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+#include "puzzle_format.h"
+#include "sudoku_core.h"
+
+/**
+ * @brief Puzzles of one dataset
+ */
+typedef struct {
+    int dim;
+    int count;
+    int* cells;         // count * dim * dim cell values
+} dataset;
+
+/**
+ * @brief Measurements of one dataset
+ */
+typedef struct {
+    long solves;        // Timed solve_puzzle calls
+    long failed;        // Calls without a correct solution
+    double total_us;
+    double mean_us, p50_us, p99_us, max_us;
+    matrix_alloc_stats allocs;  // Matrix heap use summed over the timed solves
+} bench_result;
+
+// Forward declarations of helper functions
+static void usage(const char* name);
+static bool load_dataset(const char* path, dataset* set);
+static bool solution_matches(const int* puzzle, const int* solution, int dim);
+static bool run_dataset(const dataset* set, int repetitions, bench_result* result);
+static int count_unique(const dataset* set);
+static int compare_doubles(const void* a, const void* b);
+static double percentile(const double* sorted, long n, double p);
+static long peak_rss_kb(void);
+static void print_name(const char* path);
+static void get_alloc_stats(matrix_alloc_stats* stats);
+static double now_us(void);
+
+int main(int argc, char** argv) {
+    int repetitions = 3;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "r:h")) != -1) {
+        switch (opt) {
+            case 'r': repetitions = (int)strtol(optarg, NULL, 10); break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if (optind >= argc) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (repetitions < 1) repetitions = 1;
+
+    printf("{\n  \"repetitions\": %d,\n  \"datasets\": [", repetitions);
+
+    int status = 0;
+    for (int i = optind; i < argc; i++) {
+        dataset set;
+        bench_result result;
+
+        if (!load_dataset(argv[i], &set)) {
+            fprintf(stderr, "%s: cannot load dataset\n", argv[i]);
+            status = 1;
+            continue;
+        }
+        if (!run_dataset(&set, repetitions, &result)) {
+            fprintf(stderr, "%s: out of memory\n", argv[i]);
+            free(set.cells);
+            status = 1;
+            continue;
+        }
+        if (result.failed > 0) status = 1;
+
+        int unique = count_unique(&set);
+        if (unique < 0) {
+            fprintf(stderr, "%s: out of memory\n", argv[i]);
+            free(set.cells);
+            status = 1;
+            continue;
+        }
+
+        printf("%s\n    {\n      \"name\": ", i > optind ? "," : "");
+        print_name(argv[i]);
+        printf(",\n      \"dim\": %d,\n      \"puzzles\": %d,\n      \"unique\": %d,\n      \"solves\": %ld,\n      \"failed\": %ld,\n",
+               set.dim, set.count, unique, result.solves, result.failed);
+        printf("      \"puzzles_per_sec\": %.1f,\n",
+               result.total_us > 0 ? result.solves * 1e6 / result.total_us : 0.0);
+        printf("      \"latency_us\": { \"mean\": %.2f, \"p50\": %.2f, \"p99\": %.2f, \"max\": %.2f },\n",
+               result.mean_us, result.p50_us, result.p99_us, result.max_us);
+        printf("      \"allocations_per_solve\": { \"heap_blocks\": %.1f, \"nodes\": %.1f },\n",
+               (double)result.allocs.heap_blocks / result.solves, (double)result.allocs.nodes / result.solves);
+        printf("      \"peak_rss_kb\": %ld\n    }", peak_rss_kb());
+
+        free(set.cells);
+    }
+
+    printf("\n  ],\n  \"peak_rss_kb\": %ld\n}\n", peak_rss_kb());
+
+    free_matrix_templates();
+    return status;
+}
+
+/**
+ * @brief Print the command line usage
+ * @param name Program name
+ */
+static void usage(const char* name) {
+    fprintf(stderr,
+            "usage: %s [-r repetitions] dataset...\n"
+            "  -r repetitions  times every puzzle is solved (default: 3)\n",
+            name);
+}
+
+/**
+ * @brief Read every puzzle of a dataset file
+ * @param path Path of the dataset file
+ * @param set Dataset to fill, its cells must be freed by the caller on success
+ * @return true on success, false if the file cannot be read or holds a bad puzzle
+ */
+static bool load_dataset(const char* path, dataset* set) {
+    FILE* in = fopen(path, "r");
+    if (!in) return false;
+
+    char* line = NULL;
+    size_t line_cap = 0;
+    ssize_t n;
+    int capacity = 0;
+    bool ok = true;
+
+    set->dim = 0;
+    set->count = 0;
+    set->cells = NULL;
+
+    while (ok && (n = getline(&line, &line_cap, in)) != -1) {
+        size_t len = (size_t)n;
+        while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) len--;
+        if (!is_puzzle_line(line, len)) continue;
+
+        // The first puzzle fixes the dimension of the whole dataset
+        if (set->dim == 0) set->dim = puzzle_dim_from_length(len);
+        if (set->dim <= 0) {
+            ok = false;
+            break;
+        }
+
+        size_t num_cells = (size_t)set->dim * set->dim;
+        if (set->count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            int* cells = (int*)realloc(set->cells, sizeof(int) * num_cells * capacity);
+            if (!cells) {
+                ok = false;
+                break;
+            }
+            set->cells = cells;
+        }
+
+        ok = parse_puzzle_line(line, len, set->dim, set->cells + num_cells * set->count);
+        if (ok) set->count++;
+    }
+
+    free(line);
+    fclose(in);
+
+    if (!ok || set->count == 0) {
+        free(set->cells);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Check that a solution is a valid grid that keeps every given of its puzzle
+ * @param puzzle Puzzle cells (0 for empty)
+ * @param solution Solution cells
+ * @param dim Dimension of the puzzle
+ * @return true if the solution is correct
+ */
+static bool solution_matches(const int* puzzle, const int* solution, int dim) {
+    for (int i = 0; i < dim * dim; i++) {
+        if (puzzle[i] != 0 && puzzle[i] != solution[i]) return false;
+    }
+
+    return validate_solution(solution, dim);
+}
+
+/**
+ * @brief Solve every puzzle of a dataset repeatedly and collect the latencies
+ * @param set Dataset to run
+ * @param repetitions Times every puzzle is solved
+ * @param result Measurements to fill
+ * @return true on success, false if out of memory
+ */
+static bool run_dataset(const dataset* set, int repetitions, bench_result* result) {
+    int num_cells = set->dim * set->dim;
+    long solves = (long)set->count * repetitions;
+
+    double* latencies = (double*)malloc(sizeof(double) * solves);
+    int* solution = (int*)malloc(sizeof(int) * num_cells);
+    if (!latencies || !solution) {
+        free(latencies);
+        free(solution);
+        return false;
+    }
+
+    // Warm up so the matrix template of this dimension is built outside the timing
+    solve_puzzle(set->cells, set->dim, solution);
+
+    memset(result, 0, sizeof(bench_result));
+    result->solves = solves;
+
+    matrix_alloc_stats before, after;
+    get_alloc_stats(&before);
+
+    long k = 0;
+    for (int r = 0; r < repetitions; r++) {
+        for (int i = 0; i < set->count; i++) {
+            const int* puzzle = set->cells + (size_t)i * num_cells;
+
+            double start = now_us();
+            bool solved = solve_puzzle(puzzle, set->dim, solution);
+            latencies[k] = now_us() - start;
+
+            if (!solved || !solution_matches(puzzle, solution, set->dim)) result->failed++;
+            result->total_us += latencies[k++];
+        }
+    }
+
+    get_alloc_stats(&after);
+    result->allocs.heap_blocks = after.heap_blocks - before.heap_blocks;
+    result->allocs.nodes = after.nodes - before.nodes;
+
+    qsort(latencies, solves, sizeof(double), compare_doubles);
+
+    result->mean_us = result->total_us / solves;
+    result->p50_us = percentile(latencies, solves, 0.50);
+    result->p99_us = percentile(latencies, solves, 0.99);
+    result->max_us = latencies[solves - 1];
+
+    free(latencies);
+    free(solution);
+    return true;
+}
+
+/**
+ * @brief Count the puzzles of a dataset that have exactly one solution
+ * @param set Dataset to check
+ * @return Number of uniquely solvable puzzles, -1 if out of memory
+ */
+static int count_unique(const dataset* set) {
+    long long* counts = (long long*)malloc(sizeof(long long) * set->count);
+    if (!counts) return -1;
+
+    long num_threads = sysconf(_SC_NPROCESSORS_ONLN);
+    count_many(set->cells, set->count, set->dim, 2, counts, num_threads > 0 ? (int)num_threads : 1);
+
+    int unique = 0;
+    for (int i = 0; i < set->count; i++) {
+        if (counts[i] == 1) unique++;
+    }
+
+    free(counts);
+    return unique;
+}
+
+/**
+ * @brief Heap use of every matrix so far, pointer and index engine together
+ * @param stats Receives the summed counters
+ */
+static void get_alloc_stats(matrix_alloc_stats* stats) {
+    matrix_alloc_stats index;
+    get_matrix_alloc_stats(stats);
+    get_index_alloc_stats(&index);
+    stats->heap_blocks += index.heap_blocks;
+    stats->nodes += index.nodes;
+}
+
+/**
+ * @brief qsort comparison of two doubles in ascending order
+ * @param a Pointer to the first double
+ * @param b Pointer to the second double
+ * @return Negative, zero or positive as a is less than, equal to or greater than b
+ */
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Nearest-rank percentile of sorted samples
+ * @param sorted Samples in ascending order
+ * @param n Number of samples, at least 1
+ * @param p Percentile as a fraction between 0 and 1
+ * @return Smallest sample with at least a fraction p of the samples at or below it
+ */
+static double percentile(const double* sorted, long n, double p) {
+    long rank = (long)(p * n + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > n) rank = n;
+    return sorted[rank - 1];
+}
+
+/**
+ * @brief Peak resident memory of the process so far
+ * @return Peak resident set size in kilobytes
+ */
+static long peak_rss_kb(void) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;  // Reported in bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+/**
+ * @brief Print the dataset name, the file name without directory and extension, as a JSON string
+ * @param path Path of the dataset file
+ */
+static void print_name(const char* path) {
+    const char* name = strrchr(path, '/');
+    name = name ? name + 1 : path;
+    const char* dot = strrchr(name, '.');
+    size_t len = dot && dot != name ? (size_t)(dot - name) : strlen(name);
+
+    putchar('"');
+    for (size_t i = 0; i < len; i++) {
+        if (name[i] == '"' || name[i] == '\\') putchar('\\');
+        if ((unsigned char)name[i] >= 0x20) putchar(name[i]);
+    }
+    putchar('"');
+}
+
+/**
+ * @brief Monotonic wall clock time
+ * @return Time in microseconds
+ */
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec * 1e-3;
+}
@@ -0,0 +1,81 @@
+#include <math.h>
+#include "puzzle_format.h"
+
+// Forward declarations of helper functions
+static int cell_value(char c, int dim);
+static char cell_char(int value);
+
+/**
+ * @brief Work out the dimension of a puzzle from its line length
+ * @param len Number of cells on the line
+ * @return Dimension, or -1 if len is not the cell count of a square-box grid
+ */
+int puzzle_dim_from_length(size_t len) {
+    int dim = (int)(sqrt((double)len) + 0.5);
+    int box = (int)(sqrt((double)dim) + 0.5);
+
+    if ((size_t)dim * dim != len || box * box != dim || dim > PUZZLE_FORMAT_MAX_DIM) return -1;
+    return dim;
+}
+
+/**
+ * @brief Parse a puzzle line into cell values
+ * @param line Start of the line
+ * @param len Length of the line without its line ending
+ * @param dim Dimension of the puzzle
+ * @param cells Array of dim * dim cells to fill
+ * @return true on success, false if the line has the wrong length or a bad character
+ */
+bool parse_puzzle_line(const char* line, size_t len, int dim, int* cells) {
+    if (len != (size_t)dim * dim) return false;
+
+    for (size_t i = 0; i < len; i++) {
+        int value = cell_value(line[i], dim);
+        if (value < 0 || value > dim) return false;
+        cells[i] = value;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Format a grid as one line
+ * @param cells Cell values of the grid (0 for empty cells)
+ * @param num_cells Number of cells
+ * @param line Buffer of at least num_cells + 1 characters, receives the cells and a newline
+ */
+void format_puzzle_line(const int* cells, int num_cells, char* line) {
+    for (int i = 0; i < num_cells; i++) {
+        line[i] = cell_char(cells[i]);
+    }
+    line[num_cells] = '\n';
+}
+
+/**
+ * @brief Decode one cell character
+ *
+ * Lower case letters repeat the upper case ones unless the grid needs values
+ * past 'Z', in which case they carry on from 36.
+ *
+ * @param c Cell character
+ * @param dim Dimension of the puzzle
+ * @return Cell value (0 for empty), or -1 if c is not a cell character
+ */
+static int cell_value(char c, int dim) {
+    if (c == '0' || c == '.') return 0;
+    if (c >= '1' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'Z') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'z') return dim > 35 ? c - 'a' + 36 : c - 'a' + 10;
+    return -1;
+}
+
+/**
+ * @brief Encode one cell value
+ * @param value Cell value, 0 to PUZZLE_FORMAT_MAX_DIM
+ * @return Cell character
+ */
+static char cell_char(int value) {
+    if (value == 0) return '.';
+    if (value <= 9) return (char)('0' + value);
+    return value <= 35 ? (char)('A' + value - 10) : (char)('a' + value - 36);
+}
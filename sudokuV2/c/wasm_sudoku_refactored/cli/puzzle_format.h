@@ -0,0 +1,64 @@
+#ifndef PUZZLE_FORMAT_H
+#define PUZZLE_FORMAT_H
+
+/**
+ * @file puzzle_format.h
+ * @brief One line per puzzle text format shared by the native tools
+ *
+ * Every cell is one character: '1'-'9' for the values 1 to 9, 'A'-'Z' for
+ * 10 to 35, '0' or '.' for an empty cell. Up to 25x25 letters may be in
+ * either case; grids larger than 35x35 (36x36 and 49x49) go on with 'a'-'z'
+ * for 36 and up. A puzzle of dimension dim is a line of dim * dim cells;
+ * blank lines and lines starting with '#' are not puzzles.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Largest value the format can express (9 digits + 26 upper and 26 lower case letters)
+#define PUZZLE_FORMAT_MAX_DIM 61
+
+/**
+ * @brief Check whether a line holds a puzzle rather than a comment or nothing
+ * @param line Start of the line
+ * @param len Length of the line without its line ending
+ * @return true if the line should be parsed as a puzzle
+ */
+static inline bool is_puzzle_line(const char* line, size_t len) {
+    return len > 0 && line[0] != '#';
+}
+
+/**
+ * @brief Work out the dimension of a puzzle from its line length
+ * @param len Number of cells on the line
+ * @return Dimension, or -1 if len is not the cell count of a square-box grid
+ */
+int puzzle_dim_from_length(size_t len);
+
+/**
+ * @brief Parse a puzzle line into cell values
+ * @param line Start of the line
+ * @param len Length of the line without its line ending
+ * @param dim Dimension of the puzzle
+ * @param cells Array of dim * dim cells to fill
+ * @return true on success, false if the line has the wrong length or a bad character
+ */
+bool parse_puzzle_line(const char* line, size_t len, int dim, int* cells);
+
+/**
+ * @brief Format a grid as one line
+ * @param cells Cell values of the grid (0 for empty cells)
+ * @param num_cells Number of cells
+ * @param line Buffer of at least num_cells + 1 characters, receives the cells and a newline
+ */
+void format_puzzle_line(const int* cells, int num_cells, char* line);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PUZZLE_FORMAT_H */
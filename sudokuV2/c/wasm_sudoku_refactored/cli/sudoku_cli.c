@@ -0,0 +1,240 @@
+/**
+ * @file sudoku_cli.c
+ * @brief Native batch solver for puzzle corpora
+ *
+ * Usage: sudoku_cli [-t threads] [-d dim] [-o output] [-q] corpus
+ *
+ * The corpus holds one puzzle per line in the format of puzzle_format.h.
+ * The dimension is taken from the first puzzle unless given with -d.
+ *
+ * The file is memory mapped and read in batches, each solved with
+ * solve_many. Every puzzle line gets one output line, in input order: the
+ * solved grid in the same encoding, "unsolvable" or "invalid". A summary
+ * with the throughput is printed to stderr at the end.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "puzzle_format.h"
+#include "sudoku_core.h"
+
+// Cells parsed and solved per batch, which bounds memory use for any corpus size
+#define BATCH_CELLS (1 << 22)
+
+/**
+ * @brief Read position in a memory mapped corpus
+ */
+typedef struct {
+    const char* data;
+    size_t size, pos;
+} corpus;
+
+/**
+ * @brief Puzzle totals over the whole run
+ */
+typedef struct {
+    long puzzles, solved, unsolvable, invalid;
+} run_totals;
+
+// Forward declarations of helper functions
+static void usage(const char* name);
+static bool next_line(corpus* in, const char** line, size_t* len);
+static void write_grid(FILE* out, const int* cells, int num_cells);
+static double now(void);
+
+int main(int argc, char** argv) {
+    long num_threads = sysconf(_SC_NPROCESSORS_ONLN);
+    int dim = 0;
+    const char* output_path = NULL;
+    bool quiet = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "t:d:o:qh")) != -1) {
+        switch (opt) {
+            case 't': num_threads = strtol(optarg, NULL, 10); break;
+            case 'd': dim = (int)strtol(optarg, NULL, 10); break;
+            case 'o': output_path = optarg; break;
+            case 'q': quiet = true; break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    if (optind != argc - 1) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (num_threads < 1) num_threads = 1;
+
+    int fd = open(argv[optind], O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        perror(argv[optind]);
+        return 1;
+    }
+
+    corpus in = { NULL, (size_t)st.st_size, 0 };
+    if (in.size > 0) {
+        void* map = mmap(NULL, in.size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            perror("mmap");
+            close(fd);
+            return 1;
+        }
+        madvise(map, in.size, MADV_SEQUENTIAL);
+        in.data = (const char*)map;
+    }
+
+    FILE* out = output_path ? fopen(output_path, "w") : stdout;
+    if (!out) {
+        perror(output_path);
+        return 1;
+    }
+    setvbuf(out, NULL, _IOFBF, 1 << 20);
+
+    // Take the dimension from the first puzzle line
+    const char* line;
+    size_t len;
+    if (dim == 0) {
+        corpus probe = in;
+        if (next_line(&probe, &line, &len)) dim = puzzle_dim_from_length(len);
+    }
+    if (dim < 0 || (dim > 0 && puzzle_dim_from_length((size_t)dim * dim) != dim)) {
+        fprintf(stderr, "unsupported puzzle dimension\n");
+        return 1;
+    }
+
+    run_totals totals = { 0, 0, 0, 0 };
+    double start = now();
+
+    if (dim > 0) {
+        int num_cells = dim * dim;
+        int batch_size = BATCH_CELLS / num_cells > 0 ? BATCH_CELLS / num_cells : 1;
+
+        int* puzzles = (int*)malloc(sizeof(int) * num_cells * batch_size);
+        int* solutions = (int*)malloc(sizeof(int) * num_cells * batch_size);
+        search_status* status = (search_status*)malloc(sizeof(search_status) * batch_size);
+        int* slot = (int*)malloc(sizeof(int) * batch_size);     // Puzzle index of each line, -1 if invalid
+        if (!puzzles || !solutions || !status || !slot) {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+
+        bool more = true;
+        while (more) {
+            int num_lines = 0, num_puzzles = 0;
+
+            while (num_lines < batch_size && (more = next_line(&in, &line, &len))) {
+                int* cells = puzzles + (size_t)num_puzzles * num_cells;
+                slot[num_lines++] = parse_puzzle_line(line, len, dim, cells) ? num_puzzles++ : -1;
+            }
+
+            totals.solved += solve_many(puzzles, num_puzzles, dim, solutions, status, (int)num_threads);
+
+            // Results go out in input order, one line per puzzle line
+            for (int i = 0; i < num_lines; i++) {
+                totals.puzzles++;
+
+                if (slot[i] < 0) {
+                    totals.invalid++;
+                    if (!quiet) fputs("invalid\n", out);
+                } else if (status[slot[i]] != SEARCH_SOLVED) {
+                    totals.unsolvable++;
+                    if (!quiet) fputs("unsolvable\n", out);
+                } else if (!quiet) {
+                    write_grid(out, solutions + (size_t)slot[i] * num_cells, num_cells);
+                }
+            }
+        }
+
+        free(puzzles);
+        free(solutions);
+        free(status);
+        free(slot);
+    }
+
+    fflush(out);
+    double elapsed = now() - start;
+
+    fprintf(stderr, "%ld puzzles (%ld solved, %ld unsolvable, %ld invalid) in %.3f s, %.0f puzzles/s\n",
+            totals.puzzles, totals.solved, totals.unsolvable, totals.invalid, elapsed,
+            elapsed > 0 ? totals.puzzles / elapsed : 0.0);
+
+    if (out != stdout) fclose(out);
+    if (in.data) munmap((void*)in.data, in.size);
+    close(fd);
+    free_matrix_templates();
+
+    return 0;
+}
+
+/**
+ * @brief Print the command line usage
+ * @param name Program name
+ */
+static void usage(const char* name) {
+    fprintf(stderr,
+            "usage: %s [-t threads] [-d dim] [-o output] [-q] corpus\n"
+            "  -t threads  solver threads (default: number of CPUs)\n"
+            "  -d dim      puzzle dimension (default: from the first line)\n"
+            "  -o output   write solutions to a file instead of stdout\n"
+            "  -q          only print the summary\n",
+            name);
+}
+
+/**
+ * @brief Find the next puzzle line of the corpus, skipping blank and comment lines
+ * @param in Corpus read position, moved past the line
+ * @param line Set to the start of the line
+ * @param len Set to the length of the line without its line ending
+ * @return true if a line was found, false at the end of the corpus
+ */
+static bool next_line(corpus* in, const char** line, size_t* len) {
+    while (in->pos < in->size) {
+        const char* start = in->data + in->pos;
+        const char* end = (const char*)memchr(start, '\n', in->size - in->pos);
+        size_t n = end ? (size_t)(end - start) : in->size - in->pos;
+
+        in->pos += n + (end ? 1 : 0);
+        if (n > 0 && start[n - 1] == '\r') n--;
+
+        if (!is_puzzle_line(start, n)) continue;
+
+        *line = start;
+        *len = n;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Write a solved grid as one line
+ * @param out Output stream
+ * @param cells Cell values of the grid
+ * @param num_cells Number of cells
+ */
+static void write_grid(FILE* out, const int* cells, int num_cells) {
+    char buffer[PUZZLE_FORMAT_MAX_DIM * PUZZLE_FORMAT_MAX_DIM + 1];
+
+    format_puzzle_line(cells, num_cells, buffer);
+
+    fwrite(buffer, 1, (size_t)num_cells + 1, out);
+}
+
+/**
+ * @brief Monotonic wall clock time
+ * @return Time in seconds
+ */
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
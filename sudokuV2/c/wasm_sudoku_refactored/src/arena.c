@@ -0,0 +1,136 @@
+#include <stdlib.h>
+#include "arena.h"
+
+// Heap blocks taken by all arenas so far, added to atomically
+static long long heap_blocks = 0;
+
+// Forward declarations of helper functions
+static arena_chunk* create_chunk(size_t size);
+
+/**
+ * @brief Create a new arena
+ * @param initial_size Size in bytes of the first chunk
+ * @return Pointer to the new arena
+ */
+Arena* create_arena(size_t initial_size) {
+    Arena* arena = (Arena*)malloc(sizeof(Arena));
+    if (!arena) return NULL;
+
+    if (initial_size < ARENA_ALIGN) initial_size = ARENA_ALIGN;
+
+    arena->head = create_chunk(initial_size);
+    if (!arena->head) {
+        free(arena);
+        return NULL;
+    }
+
+    arena->current = arena->head;
+    arena->chunk_size = initial_size;
+    arena->num_chunks = 1;
+    __atomic_fetch_add(&heap_blocks, 1, __ATOMIC_RELAXED);
+
+    return arena;
+}
+
+/**
+ * @brief Allocate a block of memory from the arena
+ * @param arena Pointer to the arena
+ * @param size Size of the block in bytes
+ * @return Pointer to the block, or NULL if out of memory
+ */
+void* arena_alloc(Arena* arena, size_t size) {
+    if (!arena) return NULL;
+
+    size = arena_block_size(size);
+
+    arena_chunk* chunk = arena->current;
+
+    // Move on to the next chunk (kept from before a reset) or append a new one
+    while (chunk->used + size > chunk->size) {
+        if (!chunk->next) {
+            size_t chunk_size = size > arena->chunk_size ? size : arena->chunk_size;
+            chunk->next = create_chunk(chunk_size);
+            if (!chunk->next) return NULL;
+            arena->num_chunks++;
+        }
+        chunk = chunk->next;
+        arena->current = chunk;
+    }
+
+    void* block = chunk->data + chunk->used;
+    chunk->used += size;
+    return block;
+}
+
+/**
+ * @brief Release every block handed out by the arena while keeping its chunks for reuse
+ * @param arena Pointer to the arena
+ */
+void arena_reset(Arena* arena) {
+    if (!arena) return;
+
+    for (arena_chunk* chunk = arena->head; chunk != NULL; chunk = chunk->next) {
+        chunk->used = 0;
+    }
+    arena->current = arena->head;
+}
+
+/**
+ * @brief Get the number of bytes handed out by the arena, summed over its chunks
+ * @param arena Pointer to the arena
+ * @return Bytes in use, padding included
+ */
+size_t arena_used(const Arena* arena) {
+    if (!arena) return 0;
+    
+    size_t used = 0;
+    for (arena_chunk* chunk = arena->head; chunk != NULL; chunk = chunk->next) {
+        used += chunk->used;
+    }
+    return used;
+}
+
+/**
+ * @brief Delete the arena and free all of its memory at once
+ * @param arena Pointer to the arena
+ */
+void delete_arena(Arena* arena) {
+    if (!arena) return;
+
+    arena_chunk* chunk = arena->head;
+    while (chunk != NULL) {
+        arena_chunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+
+    free(arena);
+}
+
+/**
+ * @brief Get the number of heap blocks taken by all arenas so far, on every thread
+ * @return Blocks allocated since the program started
+ */
+long long arena_heap_blocks(void) {
+    return __atomic_load_n(&heap_blocks, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Allocate a chunk and its data block with a single call to malloc
+ * @param size Size of the data block in bytes
+ * @return Pointer to the new chunk
+ */
+static arena_chunk* create_chunk(size_t size) {
+    size_t header = arena_block_size(sizeof(arena_chunk));
+
+    arena_chunk* chunk = (arena_chunk*)malloc(header + size);
+    if (!chunk) return NULL;
+
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+    chunk->data = (unsigned char*)chunk + header;
+    __atomic_fetch_add(&heap_blocks, 1, __ATOMIC_RELAXED);
+
+    return chunk;
+}
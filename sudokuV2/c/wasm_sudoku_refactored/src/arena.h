@@ -0,0 +1,98 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+/**
+ * @file arena.h
+ * @brief Chunked bump allocator used to hold every node of a matrix in contiguous memory
+ */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Every block handed out is aligned to this many bytes
+#define ARENA_ALIGN 8
+
+typedef struct _arena_chunk arena_chunk;
+typedef struct _arena Arena;
+
+/**
+ * @brief Contiguous block of memory handed out by the arena
+ */
+struct _arena_chunk {
+    arena_chunk* next;
+    size_t size, used;
+    unsigned char* data;
+};
+
+/**
+ * @brief Bump allocator made of one or more chunks
+ *
+ * The first chunk is sized by the caller up front. Further chunks are only
+ * allocated when that estimate turns out to be too small.
+ */
+struct _arena {
+    arena_chunk* head, *current;
+    size_t chunk_size;
+    int num_chunks;
+};
+
+/**
+ * @brief Number of bytes an allocation of the given size really takes up in a chunk
+ * @param size Requested size in bytes
+ * @return size rounded up to ARENA_ALIGN
+ */
+static inline size_t arena_block_size(size_t size) {
+    return (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+/**
+ * @brief Create a new arena
+ * @param initial_size Size in bytes of the first chunk
+ * @return Pointer to the new arena
+ */
+Arena* create_arena(size_t initial_size);
+
+/**
+ * @brief Allocate a block of memory from the arena
+ * @param arena Pointer to the arena
+ * @param size Size of the block in bytes
+ * @return Pointer to the block, or NULL if out of memory
+ */
+void* arena_alloc(Arena* arena, size_t size);
+
+/**
+ * @brief Release every block handed out by the arena while keeping its chunks for reuse
+ * @param arena Pointer to the arena
+ */
+void arena_reset(Arena* arena);
+
+/**
+ * @brief Get the number of bytes handed out by the arena, summed over its chunks
+ * @param arena Pointer to the arena
+ * @return Bytes in use, padding included
+ */
+size_t arena_used(const Arena* arena);
+
+/**
+ * @brief Get the number of heap blocks taken by all arenas so far, on every thread
+ *
+ * Each arena and each of its chunks count one block.
+ *
+ * @return Blocks allocated since the program started
+ */
+long long arena_heap_blocks(void);
+
+/**
+ * @brief Delete the arena and free all of its memory at once
+ * @param arena Pointer to the arena
+ */
+void delete_arena(Arena* arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ARENA_H */
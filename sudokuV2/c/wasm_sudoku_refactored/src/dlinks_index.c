@@ -0,0 +1,378 @@
+#include <assert.h>
+#include <stdlib.h>
+#include "dlinks_index.h"
+
+// Heap blocks and nodes of every index matrix so far (see matrix_alloc_stats), added to atomically
+static long long index_heap_blocks = 0;
+static long long index_nodes = 0;
+
+// Forward declarations of helper functions
+static void init_index_matrix(IndexMatrix* mx);
+static int select_min_column(const IndexMatrix* mx);
+static void cover(IndexMatrix* mx, int col);
+static void uncover(IndexMatrix* mx, int col);
+static void select_row(IndexMatrix* mx, int node);
+static void deselect_row(IndexMatrix* mx, int node);
+static void unwind(IndexMatrix* mx);
+
+/**
+ * @brief Create a new index matrix
+ * @param num_rows Number of rows in the matrix
+ * @param num_cols Number of columns in the matrix
+ * @param num_nodes Maximum number of data nodes the matrix can hold
+ * @return Pointer to the new matrix
+ */
+IndexMatrix* create_index_matrix(int num_rows, int num_cols, int num_nodes) {
+    IndexMatrix* mx = (IndexMatrix*)malloc(sizeof(IndexMatrix));
+    if (!mx) return NULL;
+
+    mx->num_rows = num_rows;
+    mx->num_cols = num_cols;
+    mx->capacity = 1 + num_cols + num_nodes;
+
+    // All arrays share one block: six per-node arrays, the column counts, the
+    // first node and value of each row and the solution (at most one row per column)
+    size_t per_node = (size_t)mx->capacity;
+    size_t total = 6 * per_node + (size_t)(num_cols + 1) + 2 * (size_t)num_rows + (size_t)num_cols;
+
+    int32_t* block = (int32_t*)malloc(sizeof(int32_t) * total);
+    if (!block) {
+        free(mx);
+        return NULL;
+    }
+
+    mx->left = block;
+    mx->right = mx->left + per_node;
+    mx->up = mx->right + per_node;
+    mx->down = mx->up + per_node;
+    mx->column = mx->down + per_node;
+    mx->row = mx->column + per_node;
+    mx->count = mx->row + per_node;
+    mx->row_first = mx->count + (num_cols + 1);
+    mx->row_value = mx->row_first + num_rows;
+    mx->solution = mx->row_value + num_rows;
+
+    init_index_matrix(mx);
+
+    // The matrix and the block holding all of its arrays
+    __atomic_fetch_add(&index_heap_blocks, 2, __ATOMIC_RELAXED);
+    return mx;
+}
+
+/**
+ * @brief Append a node to the end of its row and column in O(1)
+ * @param mx Pointer to the matrix
+ * @param row Row index for the node
+ * @param col Column index for the node
+ * @return true if the node was added, false if the matrix is full
+ */
+bool index_append_node(IndexMatrix* mx, int row, int col) {
+    if (!mx) return false;
+
+    assert(row >= 0 && col >= 0 && row < mx->num_rows && col < mx->num_cols);
+
+    if (mx->num_nodes >= mx->capacity) return false;
+
+    int node = mx->num_nodes++;
+    int header = col + 1;
+
+    mx->row[node] = row;
+    mx->column[node] = header;
+
+    // Link at the bottom of the column
+    mx->up[node] = mx->up[header];
+    mx->down[node] = header;
+    mx->down[mx->up[header]] = node;
+    mx->up[header] = node;
+    mx->count[header]++;
+
+    // Link at the end of the row (left of its first node)
+    int first = mx->row_first[row];
+    if (first < 0) {
+        mx->row_first[row] = node;
+        mx->left[node] = node;
+        mx->right[node] = node;
+    } else {
+        mx->left[node] = mx->left[first];
+        mx->right[node] = first;
+        mx->right[mx->left[first]] = node;
+        mx->left[first] = node;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Cover every column of a row, fixing that row in place before the search
+ * @param mx Pointer to the matrix
+ * @param row Row index to fix
+ * @return true if the row was covered, false if it is empty or clashes with a covered column
+ */
+bool index_cover_row(IndexMatrix* mx, int row) {
+    if (!mx) return false;
+
+    assert(row >= 0 && row < mx->num_rows);
+
+    int first = mx->row_first[row];
+    if (first < 0) return false;
+
+    // A covered column has been unlinked from its neighbors in the header ring
+    int node = first;
+    do {
+        int col = mx->column[node];
+        if (mx->right[mx->left[col]] != col) return false;
+    } while ((node = mx->right[node]) != first);
+
+    select_row(mx, first);
+    return true;
+}
+
+/**
+ * @brief Delete the matrix and free its memory
+ * @param mx Pointer to the matrix
+ */
+void delete_index_matrix(IndexMatrix* mx) {
+    if (!mx) return;
+
+    __atomic_fetch_add(&index_nodes, mx->num_nodes, __ATOMIC_RELAXED);
+
+    // Every array lives in the block that starts at mx->left
+    free(mx->left);
+    free(mx);
+}
+
+/**
+ * @brief Get the heap use of every index matrix created so far
+ * @param stats Receives the counters, summed over all threads since the program started
+ */
+void get_index_alloc_stats(matrix_alloc_stats* stats) {
+    stats->heap_blocks = __atomic_load_n(&index_heap_blocks, __ATOMIC_RELAXED);
+    stats->nodes = __atomic_load_n(&index_nodes, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Search for an exact cover using Algorithm X
+ * @param mx Pointer to the matrix
+ * @return true if a solution is found, false otherwise
+ */
+bool index_alg_x_search(IndexMatrix* mx) {
+    return index_alg_x_search_budget(mx, 0) == SEARCH_SOLVED;
+}
+
+/**
+ * @brief Search for an exact cover using Algorithm X, trying at most budget rows
+ *
+ * Algorithm X without recursion: mx->solution holds the node of the chosen
+ * row at each level, and that node's column and down link are all that is
+ * needed to resume the row loop after backtracking.
+ *
+ * @param mx Pointer to the matrix
+ * @param budget Maximum number of rows to try (search tree nodes), 0 or less for no limit
+ * @return SEARCH_SOLVED, SEARCH_UNSAT or SEARCH_BUDGET_EXHAUSTED
+ */
+search_status index_alg_x_search_budget(IndexMatrix* mx, long long budget) {
+    if (!mx) return SEARCH_UNSAT;
+
+    const int32_t* column = mx->column;
+    int32_t* solution = mx->solution;
+    search_stats* stats = mx->stats;
+    long long nodes = 0;
+
+    mx->solution_count = 0;
+    mx->solved = false;
+
+    for (;;) {
+        // If matrix is empty then an exact cover exists
+        if (index_matrix_is_empty(mx)) break;
+
+        // Start at the top of the column with least number of nodes; reaching a
+        // header (its own column) means every row below it has been tried
+        int node = mx->down[select_min_column(mx)];
+        while (node == column[node]) {
+            if (mx->solution_count == 0) return SEARCH_UNSAT;
+
+            int last = solution[--mx->solution_count];
+            deselect_row(mx, last);
+            node = mx->down[last];
+
+            if (stats) stats->backtracks++;
+        }
+
+        if (budget > 0 && ++nodes > budget) {
+            unwind(mx);
+            return SEARCH_BUDGET_EXHAUSTED;
+        }
+
+        solution[mx->solution_count++] = node;
+        select_row(mx, node);
+
+        if (stats) {
+            stats->nodes++;
+            if (mx->solution_count > stats->max_depth) stats->max_depth = mx->solution_count;
+        }
+    }
+
+    // Swap the chosen nodes for the rows they belong to
+    for (int i = 0; i < mx->solution_count; i++) {
+        solution[i] = mx->row[solution[i]];
+    }
+
+    mx->solved = true;
+    return SEARCH_SOLVED;
+}
+
+/**
+ * @brief Initialize the root and column headers of the matrix
+ * @param mx Pointer to the matrix
+ */
+static void init_index_matrix(IndexMatrix* mx) {
+    int num_headers = mx->num_cols + 1;
+
+    // Root and column headers form one horizontal ring, each header is an empty column
+    for (int i = 0; i < num_headers; i++) {
+        mx->left[i] = (i == 0) ? mx->num_cols : i - 1;
+        mx->right[i] = (i == mx->num_cols) ? 0 : i + 1;
+        mx->up[i] = i;
+        mx->down[i] = i;
+        mx->column[i] = i;
+        mx->row[i] = -1;
+        mx->count[i] = 0;
+    }
+
+    for (int i = 0; i < mx->num_rows; i++) {
+        mx->row_first[i] = -1;
+        mx->row_value[i] = i;
+    }
+
+    mx->num_nodes = num_headers;
+    mx->solution_count = 0;
+    mx->stats = NULL;
+    mx->solved = false;
+}
+
+/**
+ * @brief Return header of the active column with the least number of nodes
+ *
+ * The scan stops at the first column with at most one node: a forced row
+ * (or a dead end) is as good a pick as any, and stopping there keeps the
+ * scan short on large grids where thousands of columns are active.
+ *
+ * @param mx Pointer to the matrix
+ * @return Index of the column header
+ */
+static int select_min_column(const IndexMatrix* mx) {
+    const int32_t* right = mx->right;
+    const int32_t* count = mx->count;
+
+    int min_col = right[0];
+    int min_count = count[min_col];
+
+    for (int c = right[min_col]; c != 0 && min_count > 1; c = right[c]) {
+        if (count[c] < min_count) {
+            min_col = c;
+            min_count = count[c];
+        }
+    }
+
+    return min_col;
+}
+
+/**
+ * @brief Cover a column for algorithm x
+ * @param mx Pointer to the matrix
+ * @param col Index of the column header
+ */
+static void cover(IndexMatrix* mx, int col) {
+    int32_t* left = mx->left, *right = mx->right;
+    int32_t* up = mx->up, *down = mx->down;
+    const int32_t* column = mx->column;
+    int32_t* count = mx->count;
+    long long links = 2;
+
+    // Unlink column header from its left and right neighbors
+    right[left[col]] = right[col];
+    left[right[col]] = left[col];
+
+    // For each row in the column, unlink every other node of that row from its column
+    for (int i = down[col]; i != col; i = down[i]) {
+        for (int j = right[i]; j != i; j = right[j]) {
+            down[up[j]] = down[j];
+            up[down[j]] = up[j];
+            count[column[j]]--;
+            links += 2;
+        }
+    }
+
+    if (mx->stats) {
+        mx->stats->covers++;
+        mx->stats->links += links;
+    }
+}
+
+/**
+ * @brief Uncover a column for algorithm x
+ * @param mx Pointer to the matrix
+ * @param col Index of the column header
+ */
+static void uncover(IndexMatrix* mx, int col) {
+    int32_t* left = mx->left, *right = mx->right;
+    int32_t* up = mx->up, *down = mx->down;
+    const int32_t* column = mx->column;
+    int32_t* count = mx->count;
+    long long links = 2;
+
+    // Relink rows bottom to top, nodes right to left, exactly reversing cover
+    for (int i = up[col]; i != col; i = up[i]) {
+        for (int j = left[i]; j != i; j = left[j]) {
+            down[up[j]] = j;
+            up[down[j]] = j;
+            count[column[j]]++;
+            links += 2;
+        }
+    }
+
+    right[left[col]] = col;
+    left[right[col]] = col;
+
+    if (mx->stats) {
+        mx->stats->uncovers++;
+        mx->stats->links += links;
+    }
+}
+
+/**
+ * @brief Cover every column of the row of a node, starting with the column of the node
+ * @param mx Pointer to the matrix
+ * @param node Index of a data node of the row
+ */
+static void select_row(IndexMatrix* mx, int node) {
+    int j = node;
+
+    do {
+        cover(mx, mx->column[j]);
+    } while ((j = mx->right[j]) != node);
+}
+
+/**
+ * @brief Uncover every column of the row of a node, exactly reversing select_row
+ * @param mx Pointer to the matrix
+ * @param node Index of the data node select_row was called with
+ */
+static void deselect_row(IndexMatrix* mx, int node) {
+    int j = mx->left[node];
+
+    // Iterate left from the last column that was covered, uncover each column
+    do {
+        uncover(mx, mx->column[j]);
+    } while ((j = mx->left[j]) != mx->left[node]);
+}
+
+/**
+ * @brief Revert every row chosen by the search, leaving the matrix as the search found it
+ * @param mx Pointer to the matrix
+ */
+static void unwind(IndexMatrix* mx) {
+    while (mx->solution_count > 0) {
+        deselect_row(mx, mx->solution[--mx->solution_count]);
+    }
+}
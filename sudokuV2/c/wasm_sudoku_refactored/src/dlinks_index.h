@@ -0,0 +1,130 @@
+#ifndef DLINKS_INDEX_H
+#define DLINKS_INDEX_H
+
+/**
+ * @file dlinks_index.h
+ * @brief Index based (struct of arrays) dancing links matrix for exact cover problems
+ *
+ * Nodes are identified by int32_t indices instead of pointers. Index 0 is the
+ * root, indices 1..num_cols are the column headers (column c has header c + 1)
+ * and data nodes follow. cover/uncover only touch the up/down/column arrays and
+ * the column count array, so the working set of a 9x9 puzzle stays small.
+ * A node takes 24 bytes and a row 8, so large grids such as 49x49 fit in a
+ * fraction of the memory of the pointer engine.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "dlinks_matrix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _index_matrix IndexMatrix;
+
+/**
+ * @brief Toroidally linked sparse matrix stored as parallel index arrays
+ */
+struct _index_matrix {
+    int32_t* left, *right, *up, *down;
+    int32_t* column;        // Column header index of each node
+    int32_t* row;           // Row index of each node (-1 for root and headers)
+    int32_t* count;         // Number of nodes in each column, indexed by header
+    int32_t* row_first;     // First node of each row, -1 while the row is empty
+    int32_t* row_value;     // Caller's value of each row, such as what it stands for (its index until set)
+    int32_t* solution;      // Chosen node of each level during a search, row indices once solved
+    search_stats* stats;    // Updated by searches, NULL if unused (see dlinks_matrix.h)
+    int solution_count;
+    int num_rows, num_cols;
+    int num_nodes, capacity;
+    bool solved;
+};
+
+/**
+ * @brief Create a new index matrix
+ * @param num_rows Number of rows in the matrix
+ * @param num_cols Number of columns in the matrix
+ * @param num_nodes Maximum number of data nodes the matrix can hold
+ * @return Pointer to the new matrix
+ */
+IndexMatrix* create_index_matrix(int num_rows, int num_cols, int num_nodes);
+
+/**
+ * @brief Append a node to the end of its row and column in O(1)
+ *
+ * Columns list their rows in the order nodes were appended.
+ *
+ * @param mx Pointer to the matrix
+ * @param row Row index for the node
+ * @param col Column index for the node
+ * @return true if the node was added, false if the matrix is full
+ */
+bool index_append_node(IndexMatrix* mx, int row, int col);
+
+/**
+ * @brief Cover every column of a row, fixing that row in place before the search
+ *
+ * The row is not part of the solution the search leaves in mx->solution.
+ *
+ * @param mx Pointer to the matrix
+ * @param row Row index to fix
+ * @return true if the row was covered, false if it is empty or clashes with a covered column
+ */
+bool index_cover_row(IndexMatrix* mx, int row);
+
+/**
+ * @brief Delete the matrix and free its memory
+ * @param mx Pointer to the matrix
+ */
+void delete_index_matrix(IndexMatrix* mx);
+
+/**
+ * @brief Get the heap use of every index matrix created so far
+ *
+ * Each matrix takes two heap blocks however many nodes it holds; nodes
+ * counts the root, header and data nodes of deleted matrices, as
+ * get_matrix_alloc_stats does for the pointer engine.
+ *
+ * @param stats Receives the counters, summed over all threads since the program started
+ */
+void get_index_alloc_stats(matrix_alloc_stats* stats);
+
+/**
+ * @brief Search for an exact cover using Algorithm X
+ *
+ * The search is iterative, so its depth is bounded by memory, not by the
+ * call stack. On success the chosen row indices are left in mx->solution.
+ *
+ * @param mx Pointer to the matrix
+ * @return true if a solution is found, false otherwise
+ */
+bool index_alg_x_search(IndexMatrix* mx);
+
+/**
+ * @brief Search for an exact cover using Algorithm X, trying at most budget rows
+ *
+ * When the budget runs out every row chosen by this call is reverted, so the
+ * matrix can be searched again, e.g. with a larger budget. On success the
+ * chosen row indices are left in mx->solution.
+ *
+ * @param mx Pointer to the matrix
+ * @param budget Maximum number of rows to try (search tree nodes), 0 or less for no limit
+ * @return SEARCH_SOLVED, SEARCH_UNSAT or SEARCH_BUDGET_EXHAUSTED
+ */
+search_status index_alg_x_search_budget(IndexMatrix* mx, long long budget);
+
+/**
+ * @brief Check if the index matrix is empty
+ * @param mx Pointer to the matrix
+ * @return true if every column is covered, false otherwise
+ */
+static inline bool index_matrix_is_empty(const IndexMatrix* mx) {
+    return mx->right[0] == 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DLINKS_INDEX_H */
@@ -1,53 +1,142 @@
 #include <assert.h>
 #include <stdio.h>
+#include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 #include "dlinks_matrix.h"
 
+// Heap blocks alloc_matrix takes besides the arena: the matrix, rows, cols,
+// the buckets and the solution stack with its items
+#define MATRIX_HEAP_BLOCKS 6
+
+// Heap blocks and nodes of every matrix so far (see matrix_alloc_stats), added to atomically
+static long long matrix_heap_blocks = 0;
+static long long matrix_nodes = 0;
+
 // Forward declarations of helper functions
+static Matrix* alloc_matrix(int num_rows, int num_cols, int num_primary, size_t arena_size);
+static void copy_nodes(Matrix* mx, const Matrix* src, unsigned char* base, size_t used);
+static Node* relocate(const Arena* src, unsigned char* base, const Node* node);
+static inline Node* shift(Node* node, ptrdiff_t delta);
 static void init_matrix(Matrix* mx);
 static Node* create_node(Matrix* mx, int row, int col, int type, int value, int count);
+static void append_link(Matrix* mx, int row, int col, int value, int color);
+static inline bool is_primary(const Matrix* mx, int col);
+static inline void bucket_unlink(Matrix* mx, int col);
+static inline void bucket_link(Matrix* mx, int col, int count);
 static Node* select_min_column(Matrix* matrix);
-static void cover(Node* n);
-static void uncover(Node* n);
+static void cover(Matrix* mx, Node* n);
+static void uncover(Matrix* mx, Node* n);
+static void purify(Matrix* mx, Node* p);
+static void unpurify(Matrix* mx, Node* p);
+static inline long long hide(Matrix* mx, Node* n);
+static inline long long unhide(Matrix* mx, Node* n);
+static inline void commit(Matrix* mx, Node* n);
+static inline void uncommit(Matrix* mx, Node* n);
+static void select_row(Matrix* mx, Node* n);
+static void deselect_row(Matrix* mx, Node* n);
+static Node* backtrack(Matrix* matrix, Node* row, int base);
+static void unwind(Matrix* matrix, int base);
+static long long enumerate(Matrix* matrix, long long limit, int max_depth, solution_callback callback, void* data);
+static bool row_is_free(Node* first);
+static inline bool is_stopped(const Matrix* matrix);
+static inline void count_node(Matrix* matrix);
 
 /**
  * @brief Create a new matrix
+ *
+ * The node arena is sized for DEFAULT_NODES_PER_ROW data nodes per row.
+ *
  * @param num_rows Number of rows in the matrix
  * @param num_cols Number of columns in the matrix
  * @return Pointer to the new matrix
  */
 Matrix* create_matrix(int num_rows, int num_cols) {
-    Matrix* mx = (Matrix*)malloc(sizeof(Matrix));
+    return create_matrix_sized(num_rows, num_cols, num_rows * DEFAULT_NODES_PER_ROW);
+}
+
+/**
+ * @brief Create a new matrix whose node arena is sized for a known number of data nodes
+ * @param num_rows Number of rows in the matrix
+ * @param num_cols Number of columns in the matrix
+ * @param num_nodes Expected number of data nodes (the arena grows if this is exceeded)
+ * @return Pointer to the new matrix
+ */
+Matrix* create_matrix_sized(int num_rows, int num_cols, int num_nodes) {
+    return create_matrix_xcc(num_rows, num_cols, num_cols, num_nodes);
+}
+
+/**
+ * @brief Create a new matrix whose last columns are secondary
+ * @param num_rows Number of rows in the matrix
+ * @param num_cols Number of columns in the matrix, primary and secondary
+ * @param num_primary Number of primary columns, which come first (0 to num_cols)
+ * @param num_nodes Expected number of data nodes (the arena grows if this is exceeded)
+ * @return Pointer to the new matrix, NULL if num_primary is out of range or out of memory
+ */
+Matrix* create_matrix_xcc(int num_rows, int num_cols, int num_primary, int num_nodes) {
+    if (num_primary < 0 || num_primary > num_cols) return NULL;
+    
+    // Both roots, row headers, column headers and data nodes all come from one block
+    size_t num_headers = 2 + (size_t)num_rows + (size_t)num_cols;
+    
+    Matrix* mx = alloc_matrix(num_rows, num_cols, num_primary, sizeof(Node) * (num_headers + (size_t)num_nodes));
     if (!mx) return NULL;
     
-    mx->rows = (Node**)malloc(sizeof(Node*) * num_rows);
-    if (!mx->rows) {
-        free(mx);
-        return NULL;
-    }
+    init_matrix(mx);
+    return mx;
+}
+
+/**
+ * @brief Create an independent copy of a matrix
+ *
+ * All nodes of src are copied into one block with a flat memory copy and
+ * their links are then rebased onto the copy. Covered columns stay covered.
+ * The copy starts with an empty solution stack.
+ *
+ * @param src Pointer to the matrix to copy
+ * @return Pointer to the new matrix
+ */
+Matrix* clone_matrix(const Matrix* src) {
+    if (!src) return NULL;
     
-    mx->cols = (Node**)malloc(sizeof(Node*) * num_cols);
-    if (!mx->cols) {
-        free(mx->rows);
-        free(mx);
-        return NULL;
-    }
+    size_t used = arena_used(src->arena);
     
-    mx->num_rows = num_rows;
-    mx->num_cols = num_cols;
+    Matrix* mx = alloc_matrix(src->num_rows, src->num_cols, src->num_primary, used);
+    if (!mx) return NULL;
     
-    mx->solution = create_stack();
-    if (!mx->solution) {
-        free(mx->cols);
-        free(mx->rows);
-        free(mx);
+    unsigned char* base = (unsigned char*)arena_alloc(mx->arena, used);
+    if (!base) {
+        delete_matrix(mx);
         return NULL;
     }
     
-    init_matrix(mx);
+    copy_nodes(mx, src, base, used);
     return mx;
 }
 
+/**
+ * @brief Overwrite a matrix with the contents of another, reusing its memory
+ * @param dst Pointer to the matrix to overwrite
+ * @param src Pointer to the matrix to copy
+ * @return true on success, false if the sizes differ or out of memory
+ */
+bool copy_matrix(Matrix* dst, const Matrix* src) {
+    if (!dst || !src || dst == src) return false;
+    if (dst->num_rows != src->num_rows || dst->num_cols != src->num_cols) return false;
+    if (dst->num_primary != src->num_primary) return false;
+    
+    size_t used = arena_used(src->arena);
+    
+    // A clone of src gets its block back from the start of its first chunk
+    arena_reset(dst->arena);
+    unsigned char* base = (unsigned char*)arena_alloc(dst->arena, used);
+    if (!base) return false;
+    
+    copy_nodes(dst, src, base, used);
+    return true;
+}
+
 /**
  * @brief Insert a node into the matrix
  * @param mx Pointer to the matrix
@@ -60,34 +149,45 @@ void insert_node(Matrix* mx, int row, int col, int value) {
     
     assert(row >= 0 && col >= 0 && row < mx->num_rows && col < mx->num_cols);
     
+    Node* header = mx->rows[row];
+    Node* first = header->right;
+    Node* itr = first;
+    
+    // Iterate through row to find the first node at or past col
+    if (first) {
+        while (itr->col < col && itr->right != first) {
+            itr = itr->right;
+        }
+        
+        // If node at this position already exists, reassign value and leave
+        if (itr->col == col) {
+            itr->value = value;
+            return;
+        }
+    }
+    
     // Create new node
     Node* new_node = create_node(mx, row, col, 1, value, -1);
     if (!new_node) return;
+    new_node->column = mx->cols[col];
 
-    // Iterate through row to find correct placement of node in row
-    Node* itr = mx->rows[row];
-    Node* start = itr;
-    
-    while (itr->right != start && itr->right->col < col) {
-        itr = itr->right;
-    }
-    
-    // If node at this position already exists, reassign value and leave
-    if (itr->right->col == col) {
-        itr->right->value = value;
-        free(new_node);
-        return;
+    // Link into the row ring, before itr or at the end of the row
+    if (!first) {
+        new_node->left = new_node;
+        new_node->right = new_node;
+        header->right = new_node;
+    } else {
+        if (itr->col < col) itr = first;
+        new_node->right = itr;
+        new_node->left = itr->left;
+        itr->left->right = new_node;
+        itr->left = new_node;
+        if (col < first->col) header->right = new_node;
     }
-    
-    // Reassign left and right pointers
-    new_node->right = itr->right;
-    new_node->left = itr;
-    itr->right = new_node;
-    new_node->right->left = new_node;
 
     // Iterate through column to find correct placement of node in column
     itr = mx->cols[col];
-    start = itr;
+    Node* start = itr;
     
     while (itr->down != start && itr->down->row < row) {
         itr = itr->down;
@@ -99,12 +199,46 @@ void insert_node(Matrix* mx, int row, int col, int value) {
     itr->down = new_node;
     new_node->down->up = new_node;
 
-    mx->rows[row]->count++;
-    mx->cols[col]->count++;
+    header->count++;
+    ++mx->cols[col]->count;
+    if (is_primary(mx, col)) {
+        bucket_unlink(mx, col);
+        bucket_link(mx, col, mx->cols[col]->count);
+    }
+}
+
+/**
+ * @brief Append a node at the end of its row and column in O(1)
+ * @param mx Pointer to the matrix
+ * @param row Row index for the node
+ * @param col Column index for the node
+ * @param value Value of the node
+ */
+void append_node(Matrix* mx, int row, int col, int value) {
+    if (!mx) return;
+    
+    append_link(mx, row, col, value, 0);
+}
+
+/**
+ * @brief Append a node with a color at the end of its row and column in O(1)
+ * @param mx Pointer to the matrix
+ * @param row Row index for the node
+ * @param col Secondary column index for the node (any column if color is 0)
+ * @param color Color of the node, 0 or positive
+ */
+void append_colored_node(Matrix* mx, int row, int col, int color) {
+    if (!mx) return;
+    
+    assert(color == 0 || (color > 0 && col >= mx->num_primary));
+    append_link(mx, row, col, 1, color);
 }
 
 /**
  * @brief Remove a node from the matrix
+ *
+ * The node is unlinked; its memory is reclaimed when the matrix is deleted.
+ *
  * @param mx Pointer to the matrix
  * @param row Row index of the node to remove
  * @param col Column index of the node to remove
@@ -114,27 +248,105 @@ void remove_node(Matrix* mx, int row, int col) {
     
     assert(row >= 0 && col >= 0 && row < mx->num_rows && col < mx->num_cols);
 
+    Node* header = mx->rows[row];
+    Node* first = header->right;
+    if (!first) return;
+
     // Iterate through row to find node to remove
-    Node* itr = mx->rows[row];
-    Node* start = itr;
-    
-    while (itr->right != start && itr->right->col <= col) {
+    Node* itr = first;
+    while (itr->col != col && itr->right != first) {
         itr = itr->right;
     }
     
     // If node doesn't exist, leave
     if (itr->col != col) return;
     
+    // Keep the row header pointing at the first remaining node
+    if (itr == first) {
+        header->right = (itr->right == itr) ? NULL : itr->right;
+    }
+    
     // Reassign pointers
     itr->left->right = itr->right;
     itr->right->left = itr->left;
     itr->up->down = itr->down;
     itr->down->up = itr->up;
 
-    mx->rows[row]->count--;
-    mx->cols[col]->count--;
+    header->count--;
+    --mx->cols[col]->count;
+    if (is_primary(mx, col)) {
+        bucket_unlink(mx, col);
+        bucket_link(mx, col, mx->cols[col]->count);
+    }
+    
+    // Node memory stays in the arena until the matrix is deleted
+}
+
+/**
+ * @brief Cover every column of a row, fixing that row in place before the search
+ * @param mx Pointer to the matrix
+ * @param row Row index to fix
+ * @return true if the row was covered, false if it is empty or clashes with a covered column
+ */
+bool cover_row(Matrix* mx, int row) {
+    if (!mx) return false;
+    
+    assert(row >= 0 && row < mx->num_rows);
+    
+    Node* first = mx->rows[row]->right;
+    if (!row_is_free(first)) return false;
+    
+    select_row(mx, first);
+    return true;
+}
+
+/**
+ * @brief Link a new node in after the last node of its row and column
+ * @param mx Pointer to the matrix
+ * @param row Row index for the node
+ * @param col Column index for the node, past the last node of the row
+ * @param value Value of the node
+ * @param color Color of the node
+ */
+static void append_link(Matrix* mx, int row, int col, int value, int color) {
+    assert(row >= 0 && col >= 0 && row < mx->num_rows && col < mx->num_cols);
+    
+    Node* header = mx->rows[row];
+    Node* first = header->right;
+    Node* col_header = mx->cols[col];
     
-    free(itr);
+    assert(!first || first->left->col < col);
+    assert(col_header->up == col_header || col_header->up->row < row);
+    
+    Node* new_node = create_node(mx, row, col, 1, value, -1);
+    if (!new_node) return;
+    new_node->column = col_header;
+    new_node->color = color;
+    
+    // Tail of the row ring is the node left of the first one
+    if (!first) {
+        new_node->left = new_node;
+        new_node->right = new_node;
+        header->right = new_node;
+    } else {
+        new_node->right = first;
+        new_node->left = first->left;
+        first->left->right = new_node;
+        first->left = new_node;
+    }
+    
+    // Tail of the column is the node above its header
+    new_node->down = col_header;
+    new_node->up = col_header->up;
+    col_header->up->down = new_node;
+    col_header->up = new_node;
+    
+    header->count++;
+    ++col_header->count;
+    if (is_primary(mx, col)) {
+        bucket_unlink(mx, col);
+        bucket_link(mx, col, col_header->count);
+    }
 }
 
 /**
@@ -146,32 +358,192 @@ void delete_matrix(Matrix* mx) {
     
     delete_stack(mx->solution);
     
-    // Free column headers
-    for (int i = 0; i < mx->num_cols; i++) {
-        free(mx->cols[i]);
+    // Every node lives in the arena, so there is no need to walk the rows
+    long long nodes = (long long)(arena_used(mx->arena) / arena_block_size(sizeof(Node)));
+    __atomic_fetch_add(&matrix_nodes, nodes, __ATOMIC_RELAXED);
+    delete_arena(mx->arena);
+    
+    free(mx->bucket_next);
+    free(mx->rows);
+    free(mx->cols);
+    free(mx);
+}
+
+/**
+ * @brief Get the heap use of every matrix created so far
+ * @param stats Receives the counters, summed over all threads since the program started
+ */
+void get_matrix_alloc_stats(matrix_alloc_stats* stats) {
+    stats->heap_blocks = __atomic_load_n(&matrix_heap_blocks, __ATOMIC_RELAXED) + arena_heap_blocks();
+    stats->nodes = __atomic_load_n(&matrix_nodes, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Allocate a matrix with its header arrays, solution stack and node arena
+ * @param num_rows Number of rows in the matrix
+ * @param num_cols Number of columns in the matrix
+ * @param num_primary Number of primary columns
+ * @param arena_size Size in bytes of the first arena chunk
+ * @return Pointer to the new matrix, with no nodes yet
+ */
+static Matrix* alloc_matrix(int num_rows, int num_cols, int num_primary, size_t arena_size) {
+    Matrix* mx = (Matrix*)malloc(sizeof(Matrix));
+    if (!mx) return NULL;
+    
+    mx->rows = (Node**)malloc(sizeof(Node*) * num_rows);
+    if (!mx->rows) {
+        free(mx);
+        return NULL;
     }
     
-    // Free rows and their nodes
-    for (int i = 0; i < mx->num_rows; i++) {
-        Node* itr = mx->rows[i]->right;
-        Node* start = mx->rows[i]->right;
+    mx->cols = (Node**)malloc(sizeof(Node*) * num_cols);
+    if (!mx->cols) {
+        free(mx->rows);
+        free(mx);
+        return NULL;
+    }
+    
+    mx->num_rows = num_rows;
+    mx->num_cols = num_cols;
+    mx->num_primary = num_primary;
+    mx->stop = NULL;
+    mx->stats = NULL;
+    mx->solved = false;
+    
+    // One link per column plus one bucket head per possible count (0..num_rows)
+    size_t num_links = (size_t)num_cols + (size_t)num_rows + 1;
+    mx->bucket_next = (int*)malloc(sizeof(int) * 2 * num_links);
+    if (!mx->bucket_next) {
+        free(mx->cols);
+        free(mx->rows);
+        free(mx);
+        return NULL;
+    }
+    mx->bucket_prev = mx->bucket_next + num_links;
+    
+    // Each chosen row covers or colors at least one column, which bounds the solution depth
+    mx->solution = create_stack(num_rows < num_cols ? num_rows : num_cols);
+    if (!mx->solution) {
+        free(mx->bucket_next);
+        free(mx->cols);
+        free(mx->rows);
+        free(mx);
+        return NULL;
+    }
+    
+    mx->arena = create_arena(arena_size);
+    if (!mx->arena) {
+        delete_stack(mx->solution);
+        free(mx->bucket_next);
+        free(mx->cols);
+        free(mx->rows);
+        free(mx);
+        return NULL;
+    }
+    
+    __atomic_fetch_add(&matrix_heap_blocks, MATRIX_HEAP_BLOCKS, __ATOMIC_RELAXED);
+    return mx;
+}
+
+/**
+ * @brief Copy every node of src into one block of mx and rebase all links onto it
+ *
+ * Also copies the header arrays and count buckets, and empties the solution
+ * stack of mx.
+ *
+ * @param mx Pointer to the matrix receiving the copy (same size as src)
+ * @param src Pointer to the matrix to copy
+ * @param base Block of used bytes allocated from the arena of mx
+ * @param used Number of bytes in use in the arena of src
+ */
+static void copy_nodes(Matrix* mx, const Matrix* src, unsigned char* base, size_t used) {
+    // Lay the source chunks out back to back in the new block
+    size_t offset = 0;
+    for (arena_chunk* chunk = src->arena->head; chunk != NULL; chunk = chunk->next) {
+        memcpy(base + offset, chunk->data, chunk->used);
+        offset += chunk->used;
+    }
+    
+    const Arena* arena = src->arena;
+    size_t stride = arena_block_size(sizeof(Node));
+    
+    if (arena->num_chunks == 1) {
+        // Usual case: a single source block, so every link moves by the same offset
+        ptrdiff_t delta = base - arena->head->data;
         
-        while (itr->right != start) {
-            itr = itr->right;
-            free(itr->left);
+        for (size_t i = 0; i < used; i += stride) {
+            Node* node = (Node*)(base + i);
+            node->up = shift(node->up, delta);
+            node->down = shift(node->down, delta);
+            node->left = shift(node->left, delta);
+            node->right = shift(node->right, delta);
+            node->column = shift(node->column, delta);
+        }
+    } else {
+        for (size_t i = 0; i < used; i += stride) {
+            Node* node = (Node*)(base + i);
+            node->up = relocate(arena, base, node->up);
+            node->down = relocate(arena, base, node->down);
+            node->left = relocate(arena, base, node->left);
+            node->right = relocate(arena, base, node->right);
+            node->column = relocate(arena, base, node->column);
         }
-        
-        free(itr);
     }
     
-    free(mx->rows);
-    free(mx->cols);
-    free(mx->root);
-    free(mx);
+    mx->root = relocate(arena, base, src->root);
+    mx->secondary_root = relocate(arena, base, src->secondary_root);
+    for (int i = 0; i < mx->num_rows; i++) {
+        mx->rows[i] = relocate(arena, base, src->rows[i]);
+    }
+    for (int i = 0; i < mx->num_cols; i++) {
+        mx->cols[i] = relocate(arena, base, src->cols[i]);
+    }
+    
+    // Buckets are linked by column index and need no rebasing
+    size_t bucket_size = sizeof(int) * (size_t)(mx->num_cols + mx->num_rows + 1);
+    memcpy(mx->bucket_next, src->bucket_next, bucket_size);
+    memcpy(mx->bucket_prev, src->bucket_prev, bucket_size);
+    mx->min_bucket = src->min_bucket;
+    
+    clear_stack(mx->solution);
+    mx->solved = false;
 }
 
 /**
- * @brief Instantiate and initialize a Matrix Node
+ * @brief Translate a node pointer of a source arena into the block it was copied to
+ * @param src Arena the node was allocated from
+ * @param base Start of the block holding the copied chunks back to back
+ * @param node Pointer into src (may be NULL)
+ * @return Matching pointer into base
+ */
+static Node* relocate(const Arena* src, unsigned char* base, const Node* node) {
+    if (!node) return NULL;
+    
+    const unsigned char* p = (const unsigned char*)node;
+    size_t offset = 0;
+    
+    for (arena_chunk* chunk = src->head; chunk != NULL; chunk = chunk->next) {
+        if (p >= chunk->data && p < chunk->data + chunk->used) {
+            return (Node*)(base + offset + (size_t)(p - chunk->data));
+        }
+        offset += chunk->used;
+    }
+    
+    return NULL;
+}
+
+/**
+ * @brief Move a node pointer by a fixed number of bytes, leaving NULL links alone
+ * @param node Node pointer (may be NULL)
+ * @param delta Offset in bytes between the source and destination blocks
+ * @return Shifted pointer
+ */
+static inline Node* shift(Node* node, ptrdiff_t delta) {
+    return node ? (Node*)((unsigned char*)node + delta) : NULL;
+}
+
+/**
+ * @brief Instantiate and initialize a Matrix Node from the matrix's arena
  * @param mx Pointer to the matrix
  * @param row Row index for the node
  * @param col Column index for the node
@@ -181,7 +553,7 @@ void delete_matrix(Matrix* mx) {
  * @return Pointer to the new node
  */
 static Node* create_node(Matrix* mx, int row, int col, int type, int value, int count) {
-    Node* node = (Node*)malloc(sizeof(Node));
+    Node* node = (Node*)arena_alloc(mx->arena, sizeof(Node));
     if (!node) return NULL;
     
     node->row = row;
@@ -189,11 +561,12 @@ static Node* create_node(Matrix* mx, int row, int col, int type, int value, int
     node->type = type;
     node->value = value;
     node->count = count;
+    node->color = 0;
     node->up = NULL;
     node->down = NULL;
     node->left = NULL;
     node->right = NULL;
-    node->matrix = mx;
+    node->column = node;
     
     return node;
 }
@@ -210,11 +583,12 @@ static void init_matrix(Matrix* mx) {
     if (!mx->root) return;
     
     // Instantiate array of row header nodes
+    // A row header is not part of its row's ring: right points at the first
+    // node of the row (NULL while empty), so cover/uncover never visit it
     mx->rows[0] = create_node(mx, 0, -1, 2, -1, 0);
     if (!mx->rows[0]) return;
     
-    mx->rows[0]->right = mx->rows[0];
-    mx->rows[0]->left = mx->rows[0];
+    mx->rows[0]->column = mx->root;
     mx->rows[0]->up = mx->root;
     mx->root->down = mx->rows[0];
     
@@ -222,10 +596,9 @@ static void init_matrix(Matrix* mx) {
         Node* node = create_node(mx, i, -1, 2, -1, 0);
         if (!node) return;
         
+        node->column = mx->root;
         node->up = mx->rows[i-1];
         mx->rows[i-1]->down = node;
-        node->right = node;
-        node->left = node;
         mx->rows[i] = node;
     }
     
@@ -234,105 +607,315 @@ static void init_matrix(Matrix* mx) {
     // Root.up points to last row_header
     mx->root->up = mx->rows[mx->num_rows-1];
 
-    // Instantiate array of column header nodes
-    mx->cols[0] = create_node(mx, -1, 0, 2, -1, 0);
-    if (!mx->cols[0]) return;
+    // Secondary columns get a ring of their own, so they never keep the matrix from being empty
+    mx->secondary_root = create_node(mx, -1, -1, 3, -1, -1);
+    if (!mx->secondary_root) return;
     
-    mx->cols[0]->down = mx->cols[0];
-    mx->cols[0]->up = mx->cols[0];
-    mx->cols[0]->left = mx->root;
-    mx->root->right = mx->cols[0];
+    // Instantiate array of column header nodes, each linked in at the end of its ring
+    mx->root->left = mx->root->right = mx->root;
+    mx->secondary_root->left = mx->secondary_root->right = mx->secondary_root;
     
-    for (int i = 1; i < mx->num_cols; i++) {
+    for (int i = 0; i < mx->num_cols; i++) {
         Node* node = create_node(mx, -1, i, 2, -1, 0);
         if (!node) return;
         
-        node->left = mx->cols[i-1];
+        Node* ring = is_primary(mx, i) ? mx->root : mx->secondary_root;
         node->down = node;
         node->up = node;
-        mx->cols[i-1]->right = node;
+        node->right = ring;
+        node->left = ring->left;
+        ring->left->right = node;
+        ring->left = node;
         mx->cols[i] = node;
     }
     
-    // Last col_header.right points to root
-    mx->cols[mx->num_cols-1]->right = mx->root;
-    // Root.left points to last col_header
-    mx->root->left = mx->cols[mx->num_cols-1];
     mx->root->count = 0;
     mx->solved = false;
+    
+    // Every bucket starts out empty, then each primary column joins bucket 0
+    for (int i = mx->num_cols; i <= mx->num_cols + mx->num_rows; i++) {
+        mx->bucket_next[i] = i;
+        mx->bucket_prev[i] = i;
+    }
+    mx->min_bucket = 0;
+    for (int i = 0; i < mx->num_primary; i++) {
+        bucket_link(mx, i, 0);
+    }
+}
+
+/**
+ * @brief Remove a column from its count bucket
+ * @param mx Pointer to the matrix
+ * @param col Column index
+ */
+static inline void bucket_unlink(Matrix* mx, int col) {
+    int* next = mx->bucket_next, *prev = mx->bucket_prev;
+    
+    next[prev[col]] = next[col];
+    prev[next[col]] = prev[col];
+}
+
+/**
+ * @brief Add a column at the front of the bucket for its node count
+ * @param mx Pointer to the matrix
+ * @param col Column index
+ * @param count Number of nodes in the column
+ */
+static inline void bucket_link(Matrix* mx, int col, int count) {
+    int* next = mx->bucket_next, *prev = mx->bucket_prev;
+    int head = mx->num_cols + count;
+    
+    prev[col] = head;
+    next[col] = next[head];
+    prev[next[head]] = col;
+    next[head] = col;
+    
+    if (count < mx->min_bucket) mx->min_bucket = count;
 }
 
 /**
  * @brief Return column header of column with least number of Nodes in matrix
+ *
+ * Looks in the lowest non-empty count bucket. min_bucket only ever moves up
+ * here, and only past buckets that have emptied since it was last lowered,
+ * so finding the bucket is O(1) amortized. A dead end (count 0) or a forced
+ * column (count 1) is returned straight away; otherwise the leftmost column
+ * of the bucket is picked, the same tie-break as a left to right scan of the
+ * headers, which keeps the search tree unchanged.
+ *
  * @param matrix Pointer to the matrix
  * @return Pointer to the column header with the least number of nodes
  */
 static Node* select_min_column(Matrix* matrix) {
     if (!matrix || matrix_is_empty(matrix)) return matrix->root;
     
-    Node* itr = matrix->root->right;
-    Node* min_node = itr;
-    int min_count = itr->count;
+    const int* next = matrix->bucket_next;
+    int head = matrix->num_cols + matrix->min_bucket;
     
-    while (itr->right != matrix->root) {
-        itr = itr->right;
-        if (itr->count < min_count) {
-            min_node = itr;
-            min_count = itr->count;
-        }
+    while (next[head] == head) {
+        head++;
+    }
+    matrix->min_bucket = head - matrix->num_cols;
+    
+    int min_col = next[head];
+    if (matrix->min_bucket <= 1) return matrix->cols[min_col];
+    
+    for (int col = next[min_col]; col != head; col = next[col]) {
+        if (col < min_col) min_col = col;
     }
     
-    return min_node;
+    return matrix->cols[min_col];
 }
 
 /**
  * @brief Cover a column of node n for algorithm x
+ * @param mx Pointer to the matrix
  * @param n Pointer to the node
  */
-static void cover(Node* n) {
+static void cover(Matrix* mx, Node* n) {
     if (!n) return;
     
-    Node* col = column_of(n);
+    Node* col = n->column;
+    long long links = 2;
     
-    // Unlink left and right neighbors of col from col
+    // Unlink left and right neighbors of col from col, and take it out of its bucket
     col->right->left = col->left;
     col->left->right = col->right;
+    if (is_primary(mx, col->col)) bucket_unlink(mx, col->col);
     
-    // Iterate through each Node in col top to bottom
+    // Iterate through each Node in col top to bottom, hiding its row
     for (Node* vert_itr = col->down; vert_itr != col; vert_itr = vert_itr->down) {
-        // Iterate through row left to right
-        // For each Node in this row, unlink top and bottom neighbors and reduce count of that column
-        for (Node* horiz_itr = vert_itr->right; horiz_itr != vert_itr; horiz_itr = horiz_itr->right) {
-            horiz_itr->up->down = horiz_itr->down;
-            horiz_itr->down->up = horiz_itr->up;
-            column_of(horiz_itr)->count--;
-        }
+        links += hide(mx, vert_itr);
+    }
+    
+    if (mx->stats) {
+        mx->stats->covers++;
+        mx->stats->links += links;
     }
 }
 
 /**
  * @brief Uncover a column of node n for algorithm x
+ * @param mx Pointer to the matrix
  * @param n Pointer to the node
  */
-static void uncover(Node* n) {
+static void uncover(Matrix* mx, Node* n) {
     if (!n) return;
     
-    Node* col = column_of(n);
+    Node* col = n->column;
+    long long links = 2;
     
-    // Iterate through each Node in col bottom to top
+    // Iterate through each Node in col bottom to top, restoring its row
     for (Node* vert_itr = col->up; vert_itr != col; vert_itr = vert_itr->up) {
-        // Iterate through row right to left
-        // For each Node in this row, relink top and bottom neighbors and increment count of that column
-        for (Node* horiz_itr = vert_itr->left; horiz_itr != vert_itr; horiz_itr = horiz_itr->left) {
-            horiz_itr->up->down = horiz_itr;
-            horiz_itr->down->up = horiz_itr;
-            column_of(horiz_itr)->count++;
-        }
+        links += unhide(mx, vert_itr);
     }
     
-    // Relink left and right neighbors of col to col
+    // Relink left and right neighbors of col to col, and put it back in its bucket
     col->right->left = col;
     col->left->right = col;
+    if (is_primary(mx, col->col)) bucket_link(mx, col->col, col->count);
+    
+    if (mx->stats) {
+        mx->stats->uncovers++;
+        mx->stats->links += links;
+    }
+}
+
+/**
+ * @brief Commit the secondary column of p to the color of p
+ *
+ * Rows with another color (or none) in the column are hidden. Rows with the
+ * same color stay, their node marked -1 so choosing them later leaves the
+ * column alone. The column stays in its ring with the color in its header.
+ *
+ * @param mx Pointer to the matrix
+ * @param p Pointer to a colored node
+ */
+static void purify(Matrix* mx, Node* p) {
+    Node* col = p->column;
+    int color = p->color;
+    long long links = 0;
+    
+    col->color = color;
+    for (Node* vert_itr = col->down; vert_itr != col; vert_itr = vert_itr->down) {
+        if (vert_itr->color == color) {
+            if (vert_itr != p) vert_itr->color = -1;
+        } else {
+            links += hide(mx, vert_itr);
+        }
+    }
+    
+    if (mx->stats) {
+        mx->stats->covers++;
+        mx->stats->links += links;
+    }
+}
+
+/**
+ * @brief Exactly reverse purify
+ * @param mx Pointer to the matrix
+ * @param p Pointer to the node purify was called with
+ */
+static void unpurify(Matrix* mx, Node* p) {
+    Node* col = p->column;
+    int color = p->color;
+    long long links = 0;
+    
+    for (Node* vert_itr = col->up; vert_itr != col; vert_itr = vert_itr->up) {
+        if (vert_itr->color < 0) {
+            vert_itr->color = color;
+        } else if (vert_itr->color != color) {
+            links += unhide(mx, vert_itr);
+        }
+    }
+    col->color = 0;
+    
+    if (mx->stats) {
+        mx->stats->uncovers++;
+        mx->stats->links += links;
+    }
+}
+
+/**
+ * @brief Unlink every other node of the row of n from its column
+ *
+ * Nodes marked -1 sit in a column already committed to their color, which
+ * is out of the search, so they are left linked.
+ *
+ * @param mx Pointer to the matrix
+ * @param n Pointer to a data node of the row
+ * @return Number of links changed
+ */
+static inline long long hide(Matrix* mx, Node* n) {
+    long long links = 0;
+    
+    // Iterate through row left to right
+    // For each Node in this row, unlink top and bottom neighbors and move that column down a bucket
+    for (Node* horiz_itr = n->right; horiz_itr != n; horiz_itr = horiz_itr->right) {
+        if (horiz_itr->color < 0) continue;
+        
+        horiz_itr->up->down = horiz_itr->down;
+        horiz_itr->down->up = horiz_itr->up;
+        links += 2;
+        
+        Node* other = horiz_itr->column;
+        --other->count;
+        if (is_primary(mx, other->col)) {
+            bucket_unlink(mx, other->col);
+            bucket_link(mx, other->col, other->count);
+        }
+    }
+    
+    return links;
+}
+
+/**
+ * @brief Relink every other node of the row of n, exactly reversing hide
+ * @param mx Pointer to the matrix
+ * @param n Pointer to the data node hide was called with
+ * @return Number of links changed
+ */
+static inline long long unhide(Matrix* mx, Node* n) {
+    long long links = 0;
+    
+    // Iterate through row right to left
+    // For each Node in this row, relink top and bottom neighbors and move that column up a bucket
+    for (Node* horiz_itr = n->left; horiz_itr != n; horiz_itr = horiz_itr->left) {
+        if (horiz_itr->color < 0) continue;
+        
+        horiz_itr->up->down = horiz_itr;
+        horiz_itr->down->up = horiz_itr;
+        links += 2;
+        
+        Node* other = horiz_itr->column;
+        ++other->count;
+        if (is_primary(mx, other->col)) {
+            bucket_unlink(mx, other->col);
+            bucket_link(mx, other->col, other->count);
+        }
+    }
+    
+    return links;
+}
+
+/**
+ * @brief Satisfy the column of node n for a chosen row
+ *
+ * An uncolored node covers its column, a colored one purifies it, and a
+ * node marked -1 finds its column already committed to its color.
+ *
+ * @param mx Pointer to the matrix
+ * @param n Pointer to the node
+ */
+static inline void commit(Matrix* mx, Node* n) {
+    if (n->color == 0) {
+        cover(mx, n);
+    } else if (n->color > 0) {
+        purify(mx, n);
+    }
+}
+
+/**
+ * @brief Exactly reverse commit
+ * @param mx Pointer to the matrix
+ * @param n Pointer to the node commit was called with
+ */
+static inline void uncommit(Matrix* mx, Node* n) {
+    if (n->color == 0) {
+        uncover(mx, n);
+    } else if (n->color > 0) {
+        unpurify(mx, n);
+    }
+}
+
+/**
+ * @brief Check whether a column is primary
+ * @param mx Pointer to the matrix
+ * @param col Column index
+ * @return true if the column must be covered exactly once
+ */
+static inline bool is_primary(const Matrix* mx, int col) {
+    return col < mx->num_primary;
 }
 
 /**
@@ -341,51 +924,283 @@ static void uncover(Node* n) {
  * @return true if exact cover is found, false otherwise
  */
 bool alg_x_search(Matrix* matrix) {
-    if (!matrix) return false;
+    return alg_x_search_budget(matrix, 0) == SEARCH_SOLVED;
+}
+
+/**
+ * @brief Search the toroidal matrix structure for an exact cover, trying at most budget rows
+ *
+ * Algorithm X without recursion: the solution stack doubles as the search
+ * stack. It holds the node of the chosen row at each depth, and that node's
+ * column and down link are all that is needed to resume the row loop after
+ * backtracking. Rows already on the stack when the search starts are kept.
+ *
+ * @param matrix Pointer to the matrix
+ * @param budget Maximum number of rows to try (search tree nodes), 0 or less for no limit
+ * @return SEARCH_SOLVED, SEARCH_UNSAT, or SEARCH_BUDGET_EXHAUSTED / SEARCH_STOPPED with the matrix restored
+ */
+search_status alg_x_search_budget(Matrix* matrix, long long budget) {
+    if (!matrix) return SEARCH_UNSAT;
+    
+    int base = matrix->solution->count;
+    long long nodes = 0;
+    
+    for (;;) {
+        // If matrix is empty then an exact cover exists, leave it on the stack
+        if (matrix_is_empty(matrix)) {
+            matrix->solved = true;
+            return SEARCH_SOLVED;
+        }
+        
+        // Start at the top of the column with least number of Nodes
+        // (a column with 0 Nodes starts on its own header, a dead end)
+        Node* row = backtrack(matrix, select_min_column(matrix)->down, base);
+        if (!row) return SEARCH_UNSAT;
+        
+        if (budget > 0 && ++nodes > budget) {
+            unwind(matrix, base);
+            return SEARCH_BUDGET_EXHAUSTED;
+        }
+        
+        if (is_stopped(matrix)) {
+            unwind(matrix, base);
+            return SEARCH_STOPPED;
+        }
+        
+        // Add selected row to solutions stack and cover its columns
+        push_stack(matrix->solution, row);
+        count_node(matrix);
+        select_row(matrix, row);
+    }
+}
+
+/**
+ * @brief Count the exact covers of the matrix, stopping once limit have been found
+ * @param matrix Pointer to the matrix
+ * @param limit Stop after this many solutions, 0 or less for no limit
+ * @return Number of exact covers found, at most limit
+ */
+long long alg_x_count(Matrix* matrix, long long limit) {
+    return alg_x_enumerate(matrix, limit, NULL, NULL);
+}
+
+/**
+ * @brief Report every exact cover of the matrix to a callback, stopping once limit have been found
+ * @param matrix Pointer to the matrix
+ * @param limit Stop after this many solutions, 0 or less for no limit
+ * @param callback Function called with each solution, or NULL to only count them
+ * @param data Caller data passed through to the callback
+ * @return Number of exact covers reported, at most limit
+ */
+long long alg_x_enumerate(Matrix* matrix, long long limit, solution_callback callback, void* data) {
+    return enumerate(matrix, limit, -1, callback, data);
+}
+
+/**
+ * @brief Report every partial cover of depth rows, and every exact cover of fewer rows, to a callback
+ * @param matrix Pointer to the matrix
+ * @param depth Number of rows to choose before reporting
+ * @param callback Function called with each partial or exact cover
+ * @param data Caller data passed through to the callback
+ * @return Number of covers reported
+ */
+long long alg_x_enumerate_depth(Matrix* matrix, int depth, solution_callback callback, void* data) {
+    if (depth < 0) return 0;
+    return enumerate(matrix, 0, depth, callback, data);
+}
+
+/**
+ * @brief Push a row onto the solution stack and cover every column of it
+ * @param mx Pointer to the matrix
+ * @param row Row index to choose
+ * @return true if the row was chosen, false if it is empty or clashes with a covered column
+ */
+bool push_row(Matrix* mx, int row) {
+    if (!mx) return false;
     
-    // If matrix is empty then an exact cover exists, return true
-    if (matrix_is_empty(matrix)) return (matrix->solved = true);
+    assert(row >= 0 && row < mx->num_rows);
     
-    // Select the column with least number of Nodes
-    Node* selected_col = select_min_column(matrix);
+    Node* first = mx->rows[row]->right;
+    if (!row_is_free(first)) return false;
     
-    // If selected column has 0 Nodes, then this branch has failed
-    if (selected_col->count < 1) return false;
+    push_stack(mx->solution, first);
+    select_row(mx, first);
+    return true;
+}
 
-    Node* vert_itr = selected_col->down;
-    Node* horiz_itr;
+/**
+ * @brief Revert the row on top of the solution stack
+ * @param mx Pointer to the matrix
+ */
+void pop_row(Matrix* mx) {
+    if (!mx || mx->solution->count == 0) return;
     
-    // Iterate down from selected column head
-    while (vert_itr != selected_col && !matrix->solved) {
-        // Add selected row to solutions stack
-        push_stack(matrix->solution, matrix->rows[vert_itr->row]);
+    unwind(mx, mx->solution->count - 1);
+}
 
-        horiz_itr = vert_itr;
+/**
+ * @brief Shared search loop of alg_x_enumerate and alg_x_enumerate_depth
+ *
+ * Same iterative search as alg_x_search_budget, except that reaching an
+ * empty matrix (or max_depth rows past base) reports the stack and
+ * backtracks as if the branch had failed.
+ *
+ * @param matrix Pointer to the matrix
+ * @param limit Stop after this many reports, 0 or less for no limit
+ * @param max_depth Number of rows after which to report a partial cover, negative for none
+ * @param callback Function called with each report, or NULL to only count them
+ * @param data Caller data passed through to the callback
+ * @return Number of reports
+ */
+static long long enumerate(Matrix* matrix, long long limit, int max_depth, solution_callback callback, void* data) {
+    if (!matrix) return 0;
+    
+    solution_stack* stack = matrix->solution;
+    int base = stack->count;
+    long long count = 0;
+    
+    for (;;) {
+        Node* row;
+        
+        if (matrix_is_empty(matrix) || stack->count - base == max_depth) {
+            count++;
+            
+            // The callback reads the chosen rows in place, nothing is copied
+            if (callback && !callback((Node* const*)stack->items, stack->count, data)) break;
+            if (count == limit) break;
+            
+            // The root heads no rows, so this resumes one level up
+            row = matrix->root;
+        } else {
+            row = select_min_column(matrix)->down;
+        }
         
-        // Iterate right from vertical iterator, cover each column
-        do {
-            // Skip column of row headers
-            if (horiz_itr->col >= 0) cover(horiz_itr);
-        } while ((horiz_itr = horiz_itr->right) != vert_itr);
-
-        // Search this matrix again after covering
-        // If solution found on this branch, leave loop and stop searching
-        if (alg_x_search(matrix)) break;
-
-        // Solution not found on this iteration's branch, need to revert changes to matrix
-        // Remove row from solutions, then uncover columns from this iteration
-        pop_stack(matrix->solution);
+        row = backtrack(matrix, row, base);
+        if (!row || is_stopped(matrix)) break;
+        
+        push_stack(stack, row);
+        count_node(matrix);
+        select_row(matrix, row);
+    }
+    
+    unwind(matrix, base);
+    return count;
+}
+
+/**
+ * @brief Find the next row to try, backtracking through exhausted levels of the search
+ *
+ * Reaching a header (a node that is its own column) means every row below it
+ * has been tried: the row chosen one level up is reverted and the row below
+ * that one is tried instead.
+ *
+ * @param matrix Pointer to the matrix
+ * @param row Candidate row node, or a header if its column is exhausted
+ * @param base Solution stack depth the search started at
+ * @return Data node of the next row to try, or NULL once the search is back at base
+ */
+static Node* backtrack(Matrix* matrix, Node* row, int base) {
+    solution_stack* stack = matrix->solution;
+    
+    while (row == row->column) {
+        if (stack->count == base) return NULL;
         
-        horiz_itr = vert_itr->left;
+        Node* last = (Node*)stack->items[stack->count - 1];
+        pop_stack(stack);
+        deselect_row(matrix, last);
+        row = last->down;
         
-        // Iterate left from the last column that was covered, uncover each column
-        do {
-            // Skip column of row headers
-            if (horiz_itr->col >= 0) uncover(horiz_itr);
-        } while ((horiz_itr = horiz_itr->left) != vert_itr->left);
+        if (matrix->stats) matrix->stats->backtracks++;
+    }
+    
+    return row;
+}
 
-        vert_itr = vert_itr->down;
+/**
+ * @brief Revert every row chosen since the solution stack was at base
+ * @param matrix Pointer to the matrix
+ * @param base Solution stack depth to return to
+ */
+static void unwind(Matrix* matrix, int base) {
+    solution_stack* stack = matrix->solution;
+    
+    while (stack->count > base) {
+        deselect_row(matrix, (Node*)stack->items[stack->count - 1]);
+        pop_stack(stack);
     }
+}
+
+/**
+ * @brief Commit every column of the row of node n, starting with the column of n
+ * @param mx Pointer to the matrix
+ * @param n Pointer to a data node of the row
+ */
+static void select_row(Matrix* mx, Node* n) {
+    Node* horiz_itr = n;
     
-    return matrix->solved;
-}
\ No newline at end of file
+    // Row headers sit outside the ring, so every node here is a data node
+    do {
+        commit(mx, horiz_itr);
+    } while ((horiz_itr = horiz_itr->right) != n);
+}
+
+/**
+ * @brief Uncommit every column of the row of node n, exactly reversing select_row
+ * @param mx Pointer to the matrix
+ * @param n Pointer to the data node select_row was called with
+ */
+static void deselect_row(Matrix* mx, Node* n) {
+    Node* horiz_itr = n->left;
+    
+    // Iterate left from the last column that was committed, uncommit each column
+    do {
+        uncommit(mx, horiz_itr);
+    } while ((horiz_itr = horiz_itr->left) != n->left);
+}
+
+/**
+ * @brief Check that a row has nodes and that it can still be chosen
+ *
+ * None of its columns may be covered or committed to a color, except
+ * those already committed to the row's own color there (nodes marked -1),
+ * and at least one column must be left for the row to satisfy.
+ *
+ * @param first First node of the row (NULL for an empty row)
+ * @return true if the row is compatible with the rows chosen so far
+ */
+static bool row_is_free(Node* first) {
+    if (!first) return false;
+    
+    Node* itr = first;
+    bool satisfies = false;
+    
+    // A covered column means another chosen row already satisfies that constraint
+    do {
+        if (itr->color < 0) continue;
+        if (column_is_covered(itr) || column_of(itr)->color != 0) return false;
+        satisfies = true;
+    } while ((itr = itr->right) != first);
+    
+    return satisfies;
+}
+
+/**
+ * @brief Check whether another thread has asked the search on this matrix to stop
+ * @param matrix Pointer to the matrix
+ * @return true if the matrix's stop flag is set
+ */
+static inline bool is_stopped(const Matrix* matrix) {
+    return matrix->stop && __atomic_load_n(matrix->stop, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Record a newly chosen row in the matrix's stats, if any are attached
+ * @param matrix Pointer to the matrix, with the row already on its solution stack
+ */
+static inline void count_node(Matrix* matrix) {
+    search_stats* stats = matrix->stats;
+    if (!stats) return;
+    
+    stats->nodes++;
+    if (matrix->solution->count > stats->max_depth) stats->max_depth = matrix->solution->count;
+}
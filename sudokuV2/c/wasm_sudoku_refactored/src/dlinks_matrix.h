@@ -4,9 +4,15 @@
 /**
  * @file dlinks_matrix.h
  * @brief Toroidal Matrix structure used for holding the constraints of an exact cover problem
+ *
+ * Columns 0..num_primary-1 are primary and must be covered exactly once.
+ * Any columns after them are secondary: covered at most once, or shared by
+ * any number of rows that give the node in that column the same color
+ * (exact covering with colors, Knuth's Algorithm C).
  */
 
 #include <stdbool.h>
+#include "arena.h"
 #include "solution_stack.h"
 
 #ifdef __cplusplus
@@ -16,34 +22,172 @@ extern "C" {
 typedef struct _matrix Matrix;
 typedef struct _node Node;
 
+/**
+ * @brief Outcome of a budgeted exact cover search
+ */
+typedef enum {
+    SEARCH_SOLVED = 0,          // An exact cover was found and left on the solution stack
+    SEARCH_UNSAT = 1,           // Every branch was tried without finding an exact cover
+    SEARCH_BUDGET_EXHAUSTED = 2,// The budget ran out first; the matrix is restored
+    SEARCH_STOPPED = 3          // The matrix's stop flag was raised; the matrix is restored
+} search_status;
+
+/**
+ * @brief Counters of the work done by searches on a matrix
+ *
+ * Searches add to the counters of the struct attached to the matrix (see
+ * Matrix::stats) and never reset them, so one struct can sum several calls.
+ * Only the search itself is counted: the cover calls of cover_row are not.
+ */
+typedef struct {
+    long long nodes;            // Rows tried (search tree nodes visited)
+    long long covers;           // Calls to cover
+    long long uncovers;         // Calls to uncover
+    long long links;            // Node links rewritten by cover and uncover
+    long long backtracks;       // Rows reverted to try the next row of a column
+    int max_depth;              // Most rows on the solution stack at once
+} search_stats;
+
+/**
+ * @brief Heap use of every matrix created so far, on every thread
+ *
+ * A matrix takes a fixed number of heap blocks plus one per arena chunk,
+ * however many nodes it holds; nodes counts what allocating every node on
+ * its own would have taken instead.
+ */
+typedef struct {
+    long long heap_blocks;      // Blocks taken from the heap: matrix, arrays, solution stack, arena and its chunks
+    long long nodes;            // Header and data nodes of deleted matrices
+} matrix_alloc_stats;
+
+/**
+ * @brief Receives each exact cover found by alg_x_enumerate
+ *
+ * rows points straight into the solution stack and is only valid during the
+ * call: rows[i]->row is the index of the i-th chosen row. Rows fixed before
+ * the search (e.g. with cover_row) are not included.
+ *
+ * @param rows One data node of each row in the exact cover
+ * @param num_rows Number of rows in the exact cover
+ * @param data Caller data given to alg_x_enumerate
+ * @return true to keep searching, false to stop
+ */
+typedef bool (*solution_callback)(Node* const* rows, int num_rows, void* data);
+
+// Expected number of data nodes per row when the caller gives no better estimate
+// (one per Sudoku constraint: cell, row, column and box)
+#define DEFAULT_NODES_PER_ROW 4
+
 /**
  * @brief Data node for sparse matrix
+ *
+ * column links every node straight to its column header. Headers point to
+ * themselves and row headers point to the root, which heads their column.
+ * Row headers are kept out of their row's ring; their right link is the
+ * first node of the row, or NULL while the row is empty.
  */
 struct _node {
     int row, col, value, type, count;
+    int color;                  // Color of a secondary column node (0 for none, -1 while its color is committed)
     Node* up, *down, *left, *right;
-    Matrix* matrix;
+    Node* column;
 };
 
 /**
  * @brief Toroidally linked sparse matrix
+ *
+ * Every node, headers included, is handed out by the matrix's arena so the
+ * whole structure is released at once by delete_matrix.
+ *
+ * The root heads the ring of active primary columns, so the matrix is solved
+ * once it is empty. Secondary columns hang off their own ring under
+ * secondary_root and are never in a count bucket, so the search never
+ * branches on them. The header of a secondary column holds the color
+ * committed to it, 0 while it is free.
+ *
+ * Active primary columns are also kept in count buckets: circular lists threaded
+ * through bucket_next/bucket_prev by column index, with entry
+ * num_cols + k acting as the head of the list of columns holding k nodes.
+ * Every count change moves the column to its new bucket in O(1), so the
+ * minimum-count column is found without scanning the headers.
+ *
+ * stop lets another thread cut a running search short: once the flag it
+ * points to becomes true (stored with __atomic_store_n) the search reverts
+ * its rows and returns.
+ *
+ * stats, when set, receives the work counters of every search on the matrix.
+ * Leaving it NULL keeps the search loops free of the bookkeeping.
  */
 struct _matrix {
     Node** rows, **cols;
-    Node* root;
+    Node* root, *secondary_root;
     int num_rows, num_cols;
+    int num_primary;            // Columns before this index are primary
     solution_stack* solution;
+    Arena* arena;
+    int* bucket_next, *bucket_prev;
+    int min_bucket;             // No active column holds fewer nodes than this
+    const bool* stop;           // Polled once per search node, NULL if unused
+    search_stats* stats;        // Updated by searches, NULL if unused
     bool solved;
 };
 
 /**
  * @brief Create a new matrix
+ *
+ * The node arena is sized for DEFAULT_NODES_PER_ROW data nodes per row.
+ *
  * @param num_rows Number of rows in the matrix
  * @param num_cols Number of columns in the matrix
  * @return Pointer to the new matrix
  */
 Matrix* create_matrix(int num_rows, int num_cols);
 
+/**
+ * @brief Create a new matrix whose node arena is sized for a known number of data nodes
+ * @param num_rows Number of rows in the matrix
+ * @param num_cols Number of columns in the matrix
+ * @param num_nodes Expected number of data nodes (the arena grows if this is exceeded)
+ * @return Pointer to the new matrix
+ */
+Matrix* create_matrix_sized(int num_rows, int num_cols, int num_nodes);
+
+/**
+ * @brief Create a new matrix whose last columns are secondary
+ * @param num_rows Number of rows in the matrix
+ * @param num_cols Number of columns in the matrix, primary and secondary
+ * @param num_primary Number of primary columns, which come first (0 to num_cols)
+ * @param num_nodes Expected number of data nodes (the arena grows if this is exceeded)
+ * @return Pointer to the new matrix
+ */
+Matrix* create_matrix_xcc(int num_rows, int num_cols, int num_primary, int num_nodes);
+
+/**
+ * @brief Create an independent copy of a matrix
+ *
+ * All nodes of src are copied into one block with a flat memory copy and
+ * their links are then rebased onto the copy. Covered columns stay covered.
+ * The copy starts with an empty solution stack.
+ *
+ * @param src Pointer to the matrix to copy
+ * @return Pointer to the new matrix
+ */
+Matrix* clone_matrix(const Matrix* src);
+
+/**
+ * @brief Overwrite a matrix with the contents of another, reusing its memory
+ *
+ * Same result as clone_matrix without allocating, for callers that set up
+ * many searches from one template: dst is typically an earlier clone of src,
+ * whose arena already has room for the copy. The stop flag and stats of
+ * dst are kept.
+ *
+ * @param dst Pointer to the matrix to overwrite (same dimensions as src)
+ * @param src Pointer to the matrix to copy
+ * @return true on success, false if the sizes differ or out of memory
+ */
+bool copy_matrix(Matrix* dst, const Matrix* src);
+
 /**
  * @brief Insert a node into the matrix
  * @param mx Pointer to the matrix
@@ -53,20 +197,69 @@ Matrix* create_matrix(int num_rows, int num_cols);
  */
 void insert_node(Matrix* mx, int row, int col, int value);
 
+/**
+ * @brief Append a node at the end of its row and column in O(1)
+ *
+ * Bulk builder for callers that produce nodes in order: col must be past
+ * the last column already in the row and row past the last row already in
+ * the column. Unlike insert_node no list is walked.
+ *
+ * @param mx Pointer to the matrix
+ * @param row Row index for the node
+ * @param col Column index for the node
+ * @param value Value of the node
+ */
+void append_node(Matrix* mx, int row, int col, int value);
+
+/**
+ * @brief Append a node with a color at the end of its row and column in O(1)
+ *
+ * Same ordering rules as append_node. Rows whose nodes in a secondary
+ * column share a color may all be chosen together; color 0 asks for the
+ * column alone, like an uncolored node.
+ *
+ * @param mx Pointer to the matrix
+ * @param row Row index for the node
+ * @param col Secondary column index for the node (any column if color is 0)
+ * @param color Color of the node, 0 or positive
+ */
+void append_colored_node(Matrix* mx, int row, int col, int color);
+
 /**
  * @brief Remove a node from the matrix
+ *
+ * The node is unlinked; its memory is reclaimed when the matrix is deleted.
+ *
  * @param mx Pointer to the matrix
  * @param row Row index of the node to remove
  * @param col Column index of the node to remove
  */
 void remove_node(Matrix* mx, int row, int col);
 
+/**
+ * @brief Cover every column of a row, fixing that row in place before the search
+ *
+ * Used to apply known parts of a solution (e.g. Sudoku givens) to a full
+ * matrix. The row is not pushed onto the solution stack.
+ *
+ * @param mx Pointer to the matrix
+ * @param row Row index to fix
+ * @return true if the row was covered, false if it is empty or clashes with a covered column or color
+ */
+bool cover_row(Matrix* mx, int row);
+
 /**
  * @brief Delete the matrix and free its memory
  * @param mx Pointer to the matrix
  */
 void delete_matrix(Matrix* mx);
 
+/**
+ * @brief Get the heap use of every matrix created so far
+ * @param stats Receives the counters, summed over all threads since the program started
+ */
+void get_matrix_alloc_stats(matrix_alloc_stats* stats);
+
 /**
  * @brief Search for an exact cover using Algorithm X
  * @param mx Pointer to the matrix
@@ -74,6 +267,82 @@ void delete_matrix(Matrix* mx);
  */
 bool alg_x_search(Matrix* mx);
 
+/**
+ * @brief Search for an exact cover using Algorithm X, trying at most budget rows
+ *
+ * Iterative: the depth is bounded by the preallocated solution stack instead
+ * of the call stack, and nothing is allocated during the search. The stack
+ * holds one data node of each chosen row (node->row is the row index). When
+ * the budget runs out every row chosen by this call is reverted, so the
+ * matrix can be searched again, e.g. with a larger budget.
+ *
+ * @param mx Pointer to the matrix
+ * @param budget Maximum number of rows to try (search tree nodes), 0 or less for no limit
+ * @return SEARCH_SOLVED, SEARCH_UNSAT, SEARCH_BUDGET_EXHAUSTED or SEARCH_STOPPED
+ */
+search_status alg_x_search_budget(Matrix* mx, long long budget);
+
+/**
+ * @brief Count the exact covers of the matrix, stopping once limit have been found
+ *
+ * alg_x_enumerate without a callback. A limit of 2 is enough to tell a
+ * unique solution apart.
+ *
+ * @param mx Pointer to the matrix
+ * @param limit Stop after this many solutions, 0 or less for no limit
+ * @return Number of exact covers found, at most limit
+ */
+long long alg_x_count(Matrix* mx, long long limit);
+
+/**
+ * @brief Report every exact cover of the matrix to a callback, stopping once limit have been found
+ *
+ * Runs on the matrix's own solution stack without allocating, and reverts
+ * every row it chose before returning, so the same matrix can be counted or
+ * searched again.
+ *
+ * @param mx Pointer to the matrix
+ * @param limit Stop after this many solutions, 0 or less for no limit
+ * @param callback Function called with each solution, or NULL to only count them
+ * @param data Caller data passed through to the callback
+ * @return Number of exact covers reported, at most limit
+ */
+long long alg_x_enumerate(Matrix* mx, long long limit, solution_callback callback, void* data);
+
+/**
+ * @brief Report every partial cover of depth rows, and every exact cover of fewer rows, to a callback
+ *
+ * Cuts the search tree at a fixed depth. Every exact cover of the matrix
+ * extends exactly one of the reported covers, so the reports split the
+ * search into independent subproblems (see push_row).
+ *
+ * @param mx Pointer to the matrix
+ * @param depth Number of rows to choose before reporting
+ * @param callback Function called with each partial or exact cover
+ * @param data Caller data passed through to the callback
+ * @return Number of covers reported
+ */
+long long alg_x_enumerate_depth(Matrix* mx, int depth, solution_callback callback, void* data);
+
+/**
+ * @brief Push a row onto the solution stack and cover every column of it
+ *
+ * Unlike cover_row the row becomes part of the solution: searches started
+ * afterwards keep it and report it with every solution. Replaying the rows
+ * of a partial cover restores that point of the search tree.
+ *
+ * @param mx Pointer to the matrix
+ * @param row Row index to choose
+ * @return true if the row was chosen, false if it is empty or clashes with a covered column or color
+ */
+bool push_row(Matrix* mx, int row);
+
+/**
+ * @brief Revert the row on top of the solution stack
+ * @param mx Pointer to the matrix
+ */
+void pop_row(Matrix* mx);
+
 /**
  * @brief Check if the matrix is empty
  * @param matrix Pointer to the matrix
@@ -89,10 +358,7 @@ static inline bool matrix_is_empty(Matrix* matrix) {
  * @return Pointer to the column header
  */
 static inline Node* column_of(Node* node) {
-    if (node->col == -1) {
-        return node->matrix->root;
-    }
-    return node->matrix->cols[node->col];
+    return node->column;
 }
 
 /**
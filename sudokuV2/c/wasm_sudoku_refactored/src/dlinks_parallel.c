@@ -0,0 +1,408 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include "dlinks_parallel.h"
+
+/**
+ * @brief Subproblems stored as row index lists laid out back to back
+ */
+typedef struct {
+    int* rows;              // Row indices of every subproblem
+    int* offsets;           // Subproblem i holds rows[offsets[i]..offsets[i + 1])
+    int count, capacity;    // Number of subproblems, room in offsets
+    int num_rows, rows_capacity;
+    int base;               // Solution stack depth of the matrix being cut
+    int deepest;            // Most rows chosen by any subproblem of the last cut
+    bool failed;            // An allocation failed while cutting
+} subproblem_list;
+
+/**
+ * @brief Range of subproblem indices owned by one worker
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    int top, bottom;        // Owner takes bottom - 1, thieves take top
+} work_deque;
+
+/**
+ * @brief State shared by every worker of one parallel search
+ */
+typedef struct {
+    const subproblem_list* work;
+    work_deque* deques;
+    int num_workers;
+    long long limit;
+    solution_callback callback;
+    void* data;
+    pthread_mutex_t report_lock;    // Serializes the callback and the reported count
+    long long reported;
+    bool stop;                      // Polled by every worker's search, set atomically
+} parallel_state;
+
+/**
+ * @brief One worker thread and its private copy of the matrix
+ */
+typedef struct {
+    parallel_state* state;
+    Matrix* matrix;
+    pthread_t thread;
+    int id;
+    long long count;        // Solutions counted without taking the report lock
+    search_stats stats;     // Work of this worker, added to mx's stats at the end
+} worker;
+
+/**
+ * @brief First solution kept by parallel_search
+ */
+typedef struct {
+    int* rows;
+    int num_rows;
+} first_solution;
+
+// Forward declarations of helper functions
+static bool cut_subproblems(Matrix* mx, subproblem_list* list, int target);
+static bool collect_subproblem(Node* const* rows, int num_rows, void* data);
+static void* run_worker(void* arg);
+static int take_subproblem(parallel_state* state, int id);
+static void solve_subproblem(worker* w, int index);
+static bool report_solution(Node* const* rows, int num_rows, void* data);
+static bool keep_first(Node* const* rows, int num_rows, void* data);
+static void add_stats(search_stats* total, const search_stats* part);
+
+/**
+ * @brief Report every exact cover of the matrix to a callback, searching with several threads
+ * @param mx Pointer to the matrix
+ * @param limit Stop after this many solutions, 0 or less for no limit
+ * @param callback Function called with each solution, or NULL to only count them
+ * @param data Caller data passed through to the callback
+ * @param num_threads Number of worker threads, the calling thread included
+ * @return Number of exact covers reported, at most limit (0 if out of memory)
+ */
+long long parallel_enumerate(Matrix* mx, long long limit, solution_callback callback, void* data, int num_threads) {
+    if (!mx) return 0;
+    if (num_threads < 1) num_threads = 1;
+
+    subproblem_list list = { 0 };
+    if (!cut_subproblems(mx, &list, num_threads * PARALLEL_SUBPROBLEMS_PER_THREAD)) {
+        free(list.rows);
+        free(list.offsets);
+        return 0;
+    }
+
+    parallel_state state;
+    state.work = &list;
+    state.num_workers = num_threads;
+    state.limit = limit;
+    state.callback = callback;
+    state.data = data;
+    state.reported = 0;
+    state.stop = false;
+    pthread_mutex_init(&state.report_lock, NULL);
+
+    state.deques = (work_deque*)malloc(sizeof(work_deque) * num_threads);
+    worker* workers = (worker*)malloc(sizeof(worker) * num_threads);
+
+    // Clones are taken up front, before anything searches (and so writes to) mx
+    int num_clones = 0;
+    if (state.deques && workers) {
+        while (num_clones < num_threads) {
+            workers[num_clones].matrix = clone_matrix(mx);
+            if (!workers[num_clones].matrix) break;
+            num_clones++;
+        }
+    }
+
+    long long total = 0;
+
+    if (num_clones == num_threads) {
+        // Hand out consecutive blocks of subproblems, one per worker
+        for (int i = 0; i < num_threads; i++) {
+            pthread_mutex_init(&state.deques[i].lock, NULL);
+            state.deques[i].top = (int)((long long)list.count * i / num_threads);
+            state.deques[i].bottom = (int)((long long)list.count * (i + 1) / num_threads);
+
+            workers[i].state = &state;
+            workers[i].id = i;
+            workers[i].count = 0;
+            workers[i].matrix->stop = &state.stop;
+            workers[i].stats = (search_stats){ 0 };
+            workers[i].matrix->stats = mx->stats ? &workers[i].stats : NULL;
+        }
+
+        // The calling thread is worker 0; a worker that fails to start simply
+        // leaves its deque to be stolen from
+        bool* started = (bool*)calloc(num_threads, sizeof(bool));
+        for (int i = 1; started && i < num_threads; i++) {
+            started[i] = pthread_create(&workers[i].thread, NULL, run_worker, &workers[i]) == 0;
+        }
+
+        run_worker(&workers[0]);
+
+        for (int i = 0; i < num_threads; i++) {
+            if (started && started[i]) pthread_join(workers[i].thread, NULL);
+            total += workers[i].count;
+            if (mx->stats) add_stats(mx->stats, &workers[i].stats);
+        }
+
+        // Any worker may still be stealing until every thread has been joined
+        for (int i = 0; i < num_threads; i++) {
+            pthread_mutex_destroy(&state.deques[i].lock);
+        }
+        total += state.reported;
+        free(started);
+    }
+
+    for (int i = 0; i < num_clones; i++) {
+        delete_matrix(workers[i].matrix);
+    }
+
+    pthread_mutex_destroy(&state.report_lock);
+    free(workers);
+    free(state.deques);
+    free(list.rows);
+    free(list.offsets);
+
+    return total;
+}
+
+/**
+ * @brief Count the exact covers of the matrix with several threads
+ * @param mx Pointer to the matrix
+ * @param limit Stop after this many solutions, 0 or less for no limit
+ * @param num_threads Number of worker threads, the calling thread included
+ * @return Number of exact covers found, at most limit (0 if out of memory)
+ */
+long long parallel_count(Matrix* mx, long long limit, int num_threads) {
+    return parallel_enumerate(mx, limit, NULL, NULL, num_threads);
+}
+
+/**
+ * @brief Search for an exact cover with several threads
+ * @param mx Pointer to the matrix
+ * @param num_threads Number of worker threads, the calling thread included
+ * @return SEARCH_SOLVED or SEARCH_UNSAT (also if out of memory)
+ */
+search_status parallel_search(Matrix* mx, int num_threads) {
+    if (!mx) return SEARCH_UNSAT;
+
+    // Each row of an exact cover covers at least one column
+    first_solution first = { (int*)malloc(sizeof(int) * mx->num_cols), 0 };
+    if (!first.rows) return SEARCH_UNSAT;
+
+    if (parallel_enumerate(mx, 1, keep_first, &first, num_threads) == 0) {
+        free(first.rows);
+        return SEARCH_UNSAT;
+    }
+
+    // Replay the winning rows so mx holds the solution
+    for (int i = 0; i < first.num_rows; i++) {
+        push_row(mx, first.rows[i]);
+    }
+    mx->solved = true;
+
+    free(first.rows);
+    return SEARCH_SOLVED;
+}
+
+/**
+ * @brief Cut the search tree of a matrix into at least target subproblems where possible
+ *
+ * Doubles the cut depth until enough subproblems come out, stopping early
+ * once no subproblem reaches the cut depth (every branch ended in an exact
+ * cover or a dead end). Doubling keeps the repeated cuts of a narrow tree,
+ * where forced rows add depth but few branches, within twice the last cut.
+ *
+ * @param mx Pointer to the matrix
+ * @param list Empty list to fill
+ * @param target Number of subproblems to aim for
+ * @return true on success, false if out of memory
+ */
+static bool cut_subproblems(Matrix* mx, subproblem_list* list, int target) {
+    list->base = mx->solution->count;
+
+    for (int depth = 1; ; depth = depth * 2 < mx->num_cols ? depth * 2 : mx->num_cols) {
+        list->count = 0;
+        list->num_rows = 0;
+        list->deepest = 0;
+
+        alg_x_enumerate_depth(mx, depth, collect_subproblem, list);
+        if (list->failed) return false;
+
+        if (list->count >= target || list->deepest < depth || depth == mx->num_cols) break;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Append the rows chosen below the list's base as a new subproblem
+ * @param rows One data node of each row on the solution stack
+ * @param num_rows Number of rows on the solution stack
+ * @param data Pointer to the subproblem_list
+ * @return true to keep cutting, false if out of memory
+ */
+static bool collect_subproblem(Node* const* rows, int num_rows, void* data) {
+    subproblem_list* list = (subproblem_list*)data;
+    int depth = num_rows - list->base;
+
+    // offsets needs one entry past the last subproblem
+    if (list->count + 2 > list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 64;
+        int* offsets = (int*)realloc(list->offsets, sizeof(int) * capacity);
+        if (!offsets) return !(list->failed = true);
+        list->offsets = offsets;
+        list->capacity = capacity;
+    }
+
+    if (list->num_rows + depth > list->rows_capacity) {
+        int capacity = list->rows_capacity ? list->rows_capacity * 2 : 256;
+        while (capacity < list->num_rows + depth) capacity *= 2;
+        int* buffer = (int*)realloc(list->rows, sizeof(int) * capacity);
+        if (!buffer) return !(list->failed = true);
+        list->rows = buffer;
+        list->rows_capacity = capacity;
+    }
+
+    list->offsets[list->count] = list->num_rows;
+    for (int i = list->base; i < num_rows; i++) {
+        list->rows[list->num_rows++] = rows[i]->row;
+    }
+    list->offsets[++list->count] = list->num_rows;
+
+    if (depth > list->deepest) list->deepest = depth;
+    return true;
+}
+
+/**
+ * @brief Worker thread: solve subproblems until none are left or the search is stopped
+ * @param arg Pointer to the worker
+ * @return NULL
+ */
+static void* run_worker(void* arg) {
+    worker* w = (worker*)arg;
+    int index;
+
+    while (!__atomic_load_n(&w->state->stop, __ATOMIC_RELAXED) && (index = take_subproblem(w->state, w->id)) >= 0) {
+        solve_subproblem(w, index);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Take the next subproblem from a worker's own deque, or steal one
+ *
+ * The owner works from the bottom of its block, where the subproblems it
+ * just solved were; thieves take from the top, the part least likely to be
+ * reached soon.
+ *
+ * @param state Shared search state
+ * @param id Index of the worker asking
+ * @return Index of the subproblem, or -1 once every deque is empty
+ */
+static int take_subproblem(parallel_state* state, int id) {
+    int index = -1;
+    work_deque* own = &state->deques[id];
+
+    pthread_mutex_lock(&own->lock);
+    if (own->top < own->bottom) index = --own->bottom;
+    pthread_mutex_unlock(&own->lock);
+    if (index >= 0) return index;
+
+    // Nothing new is ever queued, so one pass over the other deques is enough
+    for (int i = 1; i < state->num_workers && index < 0; i++) {
+        work_deque* victim = &state->deques[(id + i) % state->num_workers];
+
+        pthread_mutex_lock(&victim->lock);
+        if (victim->top < victim->bottom) index = victim->top++;
+        pthread_mutex_unlock(&victim->lock);
+    }
+
+    return index;
+}
+
+/**
+ * @brief Replay a subproblem on the worker's matrix and search below it
+ * @param w Pointer to the worker
+ * @param index Index of the subproblem
+ */
+static void solve_subproblem(worker* w, int index) {
+    const subproblem_list* list = w->state->work;
+    int first = list->offsets[index], last = list->offsets[index + 1];
+    int pushed = 0;
+
+    while (first + pushed < last && push_row(w->matrix, list->rows[first + pushed])) {
+        pushed++;
+    }
+
+    if (first + pushed == last) {
+        alg_x_enumerate(w->matrix, 0, report_solution, w);
+    }
+
+    while (pushed-- > 0) {
+        pop_row(w->matrix);
+    }
+}
+
+/**
+ * @brief Count a solution found by a worker and pass it on to the caller's callback
+ * @param rows One data node of each chosen row
+ * @param num_rows Number of chosen rows
+ * @param data Pointer to the worker
+ * @return true to keep searching, false once the search has been stopped
+ */
+static bool report_solution(Node* const* rows, int num_rows, void* data) {
+    worker* w = (worker*)data;
+    parallel_state* state = w->state;
+
+    // Plain counting needs no coordination, the counts are added up at the end
+    if (!state->callback && state->limit <= 0) {
+        w->count++;
+        return true;
+    }
+
+    pthread_mutex_lock(&state->report_lock);
+
+    if (!state->stop) {
+        state->reported++;
+
+        bool stop = state->callback && !state->callback(rows, num_rows, state->data);
+        if (stop || state->reported == state->limit) __atomic_store_n(&state->stop, true, __ATOMIC_RELAXED);
+    }
+
+    bool keep_going = !state->stop;
+    pthread_mutex_unlock(&state->report_lock);
+
+    return keep_going;
+}
+
+/**
+ * @brief Copy the row indices of the first solution reported
+ * @param rows One data node of each chosen row
+ * @param num_rows Number of chosen rows
+ * @param data Pointer to the first_solution
+ * @return false, one solution is enough
+ */
+static bool keep_first(Node* const* rows, int num_rows, void* data) {
+    first_solution* first = (first_solution*)data;
+
+    for (int i = 0; i < num_rows; i++) {
+        first->rows[i] = rows[i]->row;
+    }
+    first->num_rows = num_rows;
+
+    return false;
+}
+
+/**
+ * @brief Add the counters of one worker to the stats of the whole search
+ * @param total Stats to add to
+ * @param part Stats of one worker
+ */
+static void add_stats(search_stats* total, const search_stats* part) {
+    total->nodes += part->nodes;
+    total->covers += part->covers;
+    total->uncovers += part->uncovers;
+    total->links += part->links;
+    total->backtracks += part->backtracks;
+    if (part->max_depth > total->max_depth) total->max_depth = part->max_depth;
+}
@@ -0,0 +1,73 @@
+#ifndef DLINKS_PARALLEL_H
+#define DLINKS_PARALLEL_H
+
+/**
+ * @file dlinks_parallel.h
+ * @brief Multi-threaded exact cover search over a dancing links matrix
+ *
+ * The search tree is cut at a shallow depth into subproblems, each one the
+ * list of rows chosen so far. Every worker thread owns a clone of the matrix
+ * and a deque of subproblems: it replays its own subproblems one at a time
+ * and, once its deque runs dry, steals from the other end of another
+ * worker's deque. Where threads cannot be started the calling thread works
+ * through every subproblem by itself.
+ */
+
+#include <stdbool.h>
+#include "dlinks_matrix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Subproblems cut per worker, so that stealing can even out uneven subtrees
+#define PARALLEL_SUBPROBLEMS_PER_THREAD 32
+
+/**
+ * @brief Report every exact cover of the matrix to a callback, searching with several threads
+ *
+ * Calls to the callback are serialized, so it does not need to be thread
+ * safe, but solutions arrive in no particular order. Reported rows are the
+ * ones chosen by this search; rows already on mx's solution stack are left
+ * out. mx itself is only used to cut the subproblems and is restored.
+ * If mx has stats attached, the work of every worker is added to them.
+ *
+ * @param mx Pointer to the matrix
+ * @param limit Stop after this many solutions, 0 or less for no limit
+ * @param callback Function called with each solution, or NULL to only count them
+ * @param data Caller data passed through to the callback
+ * @param num_threads Number of worker threads, the calling thread included
+ * @return Number of exact covers reported, at most limit (0 if out of memory)
+ */
+long long parallel_enumerate(Matrix* mx, long long limit, solution_callback callback, void* data, int num_threads);
+
+/**
+ * @brief Count the exact covers of the matrix with several threads
+ *
+ * Without a limit every worker counts on its own and the counts are added
+ * up at the end, so no lock is taken per solution.
+ *
+ * @param mx Pointer to the matrix
+ * @param limit Stop after this many solutions, 0 or less for no limit
+ * @param num_threads Number of worker threads, the calling thread included
+ * @return Number of exact covers found, at most limit (0 if out of memory)
+ */
+long long parallel_count(Matrix* mx, long long limit, int num_threads);
+
+/**
+ * @brief Search for an exact cover with several threads
+ *
+ * The first worker to find a solution stops the others. Its rows are then
+ * pushed onto mx's solution stack, leaving mx as alg_x_search would.
+ *
+ * @param mx Pointer to the matrix
+ * @param num_threads Number of worker threads, the calling thread included
+ * @return SEARCH_SOLVED or SEARCH_UNSAT (also if out of memory)
+ */
+search_status parallel_search(Matrix* mx, int num_threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DLINKS_PARALLEL_H */
@@ -0,0 +1,254 @@
+#include <stdlib.h>
+#include "exact_cover.h"
+
+// Forward declarations of helper functions
+static bool valid_offsets(int num_rows, const int* row_offsets);
+static int sorted_row(const int* cols, const int* colors, int length, int num_cols, int num_primary, int* sorted, int* sorted_colors);
+static int read_solution(const ExactCover* ec, int* rows);
+static bool report_rows(Node* const* nodes, int num_rows, void* data);
+
+/**
+ * @brief Build an exact cover problem from a sparse row list in one pass
+ * @param num_rows Number of rows (at least 1)
+ * @param num_cols Number of columns, every one to be covered exactly once (at least 1)
+ * @param row_offsets num_rows + 1 offsets into col_indices, starting at 0 and never decreasing
+ * @param col_indices Column indices of every row, back to back
+ * @return Pointer to the new problem, NULL if the row list is malformed or out of memory
+ */
+ExactCover* create_exact_cover(int num_rows, int num_cols, const int* row_offsets, const int* col_indices) {
+    return create_exact_cover_xcc(num_rows, num_cols, 0, row_offsets, col_indices, NULL);
+}
+
+/**
+ * @brief Build an exact cover problem with secondary columns and colors from a sparse row list
+ * @param num_rows Number of rows (at least 1)
+ * @param num_primary Number of primary columns, 0 to num_primary - 1 (at least 1)
+ * @param num_secondary Number of secondary columns, num_primary onwards (0 or more)
+ * @param row_offsets num_rows + 1 offsets into col_indices, starting at 0 and never decreasing
+ * @param col_indices Column indices of every row, back to back
+ * @param colors Color of every entry of col_indices, 0 for none (NULL if no entry has one)
+ * @return Pointer to the new problem, NULL if the row list is malformed or out of memory
+ */
+ExactCover* create_exact_cover_xcc(int num_rows, int num_primary, int num_secondary,
+                                   const int* row_offsets, const int* col_indices, const int* colors) {
+    if (num_rows < 1 || num_primary < 1 || num_secondary < 0 || !row_offsets || !col_indices) return NULL;
+    if (!valid_offsets(num_rows, row_offsets)) return NULL;
+    
+    int num_cols = num_primary + num_secondary;
+    int longest = 0;
+    for (int r = 0; r < num_rows; r++) {
+        int length = row_offsets[r + 1] - row_offsets[r];
+        if (length > longest) longest = length;
+    }
+
+    ExactCover* ec = (ExactCover*)malloc(sizeof(ExactCover));
+    int* sorted = (int*)malloc(sizeof(int) * 2 * (longest > 0 ? longest : 1));
+    if (!ec || !sorted) {
+        free(ec);
+        free(sorted);
+        return NULL;
+    }
+    int* sorted_colors = sorted + (longest > 0 ? longest : 1);
+
+    ec->num_rows = num_rows;
+    ec->num_cols = num_cols;
+    ec->num_primary = num_primary;
+    ec->callback = NULL;
+    ec->data = NULL;
+    ec->matrix = create_matrix_xcc(num_rows, num_cols, num_primary, row_offsets[num_rows]);
+    ec->rows = (int*)malloc(sizeof(int) * (num_rows < num_cols ? num_rows : num_cols));
+    if (!ec->matrix || !ec->rows) {
+        free(sorted);
+        delete_exact_cover(ec);
+        return NULL;
+    }
+
+    // Rows are added in order and each row's columns ascending, so every node
+    // lands at the end of its row and column and append_colored_node never walks a list
+    for (int r = 0; r < num_rows; r++) {
+        int start = row_offsets[r];
+        int length = sorted_row(col_indices + start, colors ? colors + start : NULL,
+                                row_offsets[r + 1] - start, num_cols, num_primary, sorted, sorted_colors);
+        if (length < 0) {
+            free(sorted);
+            delete_exact_cover(ec);
+            return NULL;
+        }
+
+        for (int i = 0; i < length; i++) {
+            append_colored_node(ec->matrix, r, sorted[i], sorted_colors[i]);
+        }
+    }
+
+    free(sorted);
+    return ec;
+}
+
+/**
+ * @brief Delete an exact cover problem and free its memory
+ * @param ec Pointer to the problem
+ */
+void delete_exact_cover(ExactCover* ec) {
+    if (!ec) return;
+
+    delete_matrix(ec->matrix);
+    free(ec->rows);
+    free(ec);
+}
+
+/**
+ * @brief Find one exact cover
+ * @param ec Pointer to the problem
+ * @param rows Array of at least num_cols entries receiving the row ids of the cover
+ * @param num_chosen Receives the number of rows in the cover
+ * @return true if an exact cover exists, false otherwise
+ */
+bool exact_cover_solve(ExactCover* ec, int* rows, int* num_chosen) {
+    return exact_cover_solve_budget(ec, 0, rows, num_chosen) == SEARCH_SOLVED;
+}
+
+/**
+ * @brief Find one exact cover, trying at most budget rows
+ * @param ec Pointer to the problem
+ * @param budget Maximum number of rows to try (search tree nodes), 0 or less for no limit
+ * @param rows Array of at least num_cols entries receiving the row ids of the cover
+ * @param num_chosen Receives the number of rows in the cover (0 unless solved)
+ * @return SEARCH_SOLVED, SEARCH_UNSAT, SEARCH_BUDGET_EXHAUSTED or SEARCH_STOPPED
+ */
+search_status exact_cover_solve_budget(ExactCover* ec, long long budget, int* rows, int* num_chosen) {
+    if (num_chosen) *num_chosen = 0;
+    if (!ec) return SEARCH_UNSAT;
+
+    search_status status = alg_x_search_budget(ec->matrix, budget);
+    if (status != SEARCH_SOLVED) return status;
+
+    int count = read_solution(ec, rows);
+    if (num_chosen) *num_chosen = count;
+
+    // Revert the cover so the problem can be searched again
+    while (ec->matrix->solution->count > 0) {
+        pop_row(ec->matrix);
+    }
+    ec->matrix->solved = false;
+
+    return status;
+}
+
+/**
+ * @brief Count the exact covers, stopping once limit have been found
+ * @param ec Pointer to the problem
+ * @param limit Stop after this many solutions, 0 or less for no limit
+ * @return Number of exact covers found, at most limit
+ */
+long long exact_cover_count(ExactCover* ec, long long limit) {
+    if (!ec) return 0;
+    return alg_x_count(ec->matrix, limit);
+}
+
+/**
+ * @brief Report every exact cover to a callback as row ids, stopping once limit have been found
+ * @param ec Pointer to the problem
+ * @param limit Stop after this many solutions, 0 or less for no limit
+ * @param callback Function called with each solution
+ * @param data Caller data passed through to the callback
+ * @return Number of exact covers reported, at most limit
+ */
+long long exact_cover_enumerate(ExactCover* ec, long long limit, exact_cover_callback callback, void* data) {
+    if (!ec) return 0;
+    if (!callback) return alg_x_count(ec->matrix, limit);
+
+    ec->callback = callback;
+    ec->data = data;
+    long long count = alg_x_enumerate(ec->matrix, limit, report_rows, ec);
+    ec->callback = NULL;
+    ec->data = NULL;
+
+    return count;
+}
+
+/**
+ * @brief Check that CSR row offsets start at 0 and never decrease
+ * @param num_rows Number of rows
+ * @param row_offsets num_rows + 1 offsets
+ * @return true if the offsets describe a row list
+ */
+static bool valid_offsets(int num_rows, const int* row_offsets) {
+    if (row_offsets[0] != 0) return false;
+
+    for (int r = 0; r < num_rows; r++) {
+        if (row_offsets[r + 1] < row_offsets[r]) return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Copy the columns of one row, with their colors, in ascending order
+ *
+ * Rows are short, so an insertion sort is all that is needed.
+ *
+ * @param cols Columns of the row as given
+ * @param colors Colors of the columns as given (NULL for none)
+ * @param length Number of columns in the row
+ * @param num_cols Number of columns in the problem
+ * @param num_primary Number of primary columns, which take no color
+ * @param sorted Receives the columns in ascending order
+ * @param sorted_colors Receives the color of each sorted column
+ * @return Number of columns, or -1 if one is out of range or repeated, or has a bad color
+ */
+static int sorted_row(const int* cols, const int* colors, int length, int num_cols, int num_primary,
+                      int* sorted, int* sorted_colors) {
+    for (int i = 0; i < length; i++) {
+        int col = cols[i];
+        int color = colors ? colors[i] : 0;
+        if (col < 0 || col >= num_cols) return -1;
+        if (color < 0 || (color > 0 && col < num_primary)) return -1;
+
+        int j = i;
+        while (j > 0 && sorted[j - 1] > col) {
+            sorted[j] = sorted[j - 1];
+            sorted_colors[j] = sorted_colors[j - 1];
+            j--;
+        }
+        if (j > 0 && sorted[j - 1] == col) return -1;
+        sorted[j] = col;
+        sorted_colors[j] = color;
+    }
+
+    return length;
+}
+
+/**
+ * @brief Copy the row ids on the solution stack
+ * @param ec Pointer to the problem, with a cover on its solution stack
+ * @param rows Receives the row ids (NULL to only count them)
+ * @return Number of rows in the cover
+ */
+static int read_solution(const ExactCover* ec, int* rows) {
+    solution_stack* stack = ec->matrix->solution;
+
+    if (rows) {
+        for (int i = 0; i < stack->count; i++) {
+            rows[i] = ((Node*)stack->items[i])->row;
+        }
+    }
+
+    return stack->count;
+}
+
+/**
+ * @brief solution_callback that hands the cover on to the caller's callback as row ids
+ * @param nodes One data node of each row in the cover
+ * @param num_rows Number of rows in the cover
+ * @param data The ExactCover being enumerated
+ * @return Result of the caller's callback
+ */
+static bool report_rows(Node* const* nodes, int num_rows, void* data) {
+    ExactCover* ec = (ExactCover*)data;
+
+    for (int i = 0; i < num_rows; i++) {
+        ec->rows[i] = nodes[i]->row;
+    }
+
+    return ec->callback(ec->rows, num_rows, ec->data);
+}
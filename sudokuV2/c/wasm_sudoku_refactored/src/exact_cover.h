@@ -0,0 +1,140 @@
+#ifndef EXACT_COVER_H
+#define EXACT_COVER_H
+
+/**
+ * @file exact_cover.h
+ * @brief General exact cover problems on the dancing links engine
+ *
+ * A problem is given as a sparse row list in CSR form: the columns of row r
+ * are col_indices[row_offsets[r]] up to col_indices[row_offsets[r + 1] - 1],
+ * so row_offsets holds num_rows + 1 entries starting at 0. Solutions are
+ * reported as row ids, indices into that list, so pentomino tilings,
+ * N-queens or schedules can use the same search as the Sudoku solver.
+ *
+ * Problems built with create_exact_cover_xcc may also have secondary
+ * columns, which are covered at most once, and give entries in them a
+ * color: any number of rows may share a secondary column as long as they
+ * all give it the same color. N-queens diagonals are secondary columns, and
+ * a shared resource that several tasks may use in the same mode is a
+ * colored one.
+ */
+
+#include <stdbool.h>
+#include "dlinks_matrix.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _exact_cover ExactCover;
+
+/**
+ * @brief Receives each exact cover found by exact_cover_enumerate
+ *
+ * rows is only valid during the call.
+ *
+ * @param rows Row ids of the exact cover, in the order they were chosen
+ * @param num_rows Number of rows in the exact cover
+ * @param data Caller data given to exact_cover_enumerate
+ * @return true to keep searching, false to stop
+ */
+typedef bool (*exact_cover_callback)(const int* rows, int num_rows, void* data);
+
+/**
+ * @brief Exact cover problem built from a sparse row list
+ *
+ * Searches leave the matrix as they found it, so one problem can be solved,
+ * counted and enumerated any number of times. Attach a search_stats struct
+ * to matrix->stats to measure them.
+ */
+struct _exact_cover {
+    Matrix* matrix;
+    int* rows;                  // Row ids of the cover being reported
+    exact_cover_callback callback;
+    void* data;
+    int num_rows, num_cols;
+    int num_primary;            // Columns before this index must be covered
+};
+
+/**
+ * @brief Build an exact cover problem from a sparse row list in one pass
+ *
+ * The columns of a row may be listed in any order.
+ *
+ * @param num_rows Number of rows (at least 1)
+ * @param num_cols Number of columns, every one to be covered exactly once (at least 1)
+ * @param row_offsets num_rows + 1 offsets into col_indices, starting at 0 and never decreasing
+ * @param col_indices Column indices of every row, back to back
+ * @return Pointer to the new problem, NULL if the row list is malformed
+ *         (bad offsets, a column out of range or listed twice in a row) or out of memory
+ */
+ExactCover* create_exact_cover(int num_rows, int num_cols, const int* row_offsets, const int* col_indices);
+
+/**
+ * @brief Build an exact cover problem with secondary columns and colors from a sparse row list
+ *
+ * Column ids run from 0 to num_primary + num_secondary - 1, the secondary
+ * ones last. colors runs alongside col_indices; only entries in secondary
+ * columns may have a color other than 0. A row with no primary column is
+ * never chosen by the search.
+ *
+ * @param num_rows Number of rows (at least 1)
+ * @param num_primary Number of primary columns, every one to be covered exactly once (at least 1)
+ * @param num_secondary Number of secondary columns, each covered at most once or shared by one color (0 or more)
+ * @param row_offsets num_rows + 1 offsets into col_indices, starting at 0 and never decreasing
+ * @param col_indices Column indices of every row, back to back
+ * @param colors Color of every entry of col_indices, 0 for none (NULL if no entry has one)
+ * @return Pointer to the new problem, NULL if the row list is malformed (bad offsets, a column
+ *         out of range or listed twice in a row, a negative color or a colored primary column) or out of memory
+ */
+ExactCover* create_exact_cover_xcc(int num_rows, int num_primary, int num_secondary,
+                                   const int* row_offsets, const int* col_indices, const int* colors);
+
+/**
+ * @brief Delete an exact cover problem and free its memory
+ * @param ec Pointer to the problem
+ */
+void delete_exact_cover(ExactCover* ec);
+
+/**
+ * @brief Find one exact cover
+ * @param ec Pointer to the problem
+ * @param rows Array of at least num_cols entries receiving the row ids of the cover
+ * @param num_chosen Receives the number of rows in the cover
+ * @return true if an exact cover exists, false otherwise
+ */
+bool exact_cover_solve(ExactCover* ec, int* rows, int* num_chosen);
+
+/**
+ * @brief Find one exact cover, trying at most budget rows
+ * @param ec Pointer to the problem
+ * @param budget Maximum number of rows to try (search tree nodes), 0 or less for no limit
+ * @param rows Array of at least num_cols entries receiving the row ids of the cover
+ * @param num_chosen Receives the number of rows in the cover (0 unless solved)
+ * @return SEARCH_SOLVED, SEARCH_UNSAT, SEARCH_BUDGET_EXHAUSTED or SEARCH_STOPPED
+ */
+search_status exact_cover_solve_budget(ExactCover* ec, long long budget, int* rows, int* num_chosen);
+
+/**
+ * @brief Count the exact covers, stopping once limit have been found
+ * @param ec Pointer to the problem
+ * @param limit Stop after this many solutions, 0 or less for no limit
+ * @return Number of exact covers found, at most limit
+ */
+long long exact_cover_count(ExactCover* ec, long long limit);
+
+/**
+ * @brief Report every exact cover to a callback as row ids, stopping once limit have been found
+ * @param ec Pointer to the problem
+ * @param limit Stop after this many solutions, 0 or less for no limit
+ * @param callback Function called with each solution
+ * @param data Caller data passed through to the callback
+ * @return Number of exact covers reported, at most limit
+ */
+long long exact_cover_enumerate(ExactCover* ec, long long limit, exact_cover_callback callback, void* data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EXACT_COVER_H */
@@ -3,44 +3,61 @@
 
 /**
  * @file solution_stack.h
- * @brief Simple linked node based stack for holding solution to algorithm x
+ * @brief Preallocated array based stack for holding solution to algorithm x
  */
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-typedef struct _solution_node solution_node;
 typedef struct _solution_stack solution_stack;
 
-struct _solution_node {
-    void* data;
-    solution_node* next;
-};
-
+/**
+ * @brief Fixed capacity stack, items[0] is the bottom and items[count - 1] the top
+ */
 struct _solution_stack {
-    solution_node* head;
-    int count;
+    void** items;
+    int count, capacity;
 };
 
 /**
  * @brief Create a new solution stack
+ * @param capacity Maximum number of items (the deepest possible solution)
  * @return Pointer to the new solution stack
  */
-solution_stack* create_stack(void);
+solution_stack* create_stack(int capacity);
 
 /**
  * @brief Push data onto the solution stack
+ *
+ * Never allocates; pushes past the capacity are ignored.
+ *
  * @param stack Pointer to the solution stack
  * @param data Data to push onto the stack
  */
-void push_stack(solution_stack* stack, void* data);
+static inline void push_stack(solution_stack* stack, void* data) {
+    if (stack->count < stack->capacity) {
+        stack->items[stack->count++] = data;
+    }
+}
 
 /**
  * @brief Pop data from the solution stack
  * @param stack Pointer to the solution stack
  */
-void pop_stack(solution_stack* stack);
+static inline void pop_stack(solution_stack* stack) {
+    if (stack->count > 0) {
+        stack->count--;
+    }
+}
+
+/**
+ * @brief Remove every item from the solution stack
+ * @param stack Pointer to the solution stack
+ */
+static inline void clear_stack(solution_stack* stack) {
+    stack->count = 0;
+}
 
 /**
  * @brief Delete the solution stack and free its memory
@@ -52,4 +69,4 @@ void delete_stack(solution_stack* stack);
 }
 #endif
 
-#endif /* SOLUTION_STACK_H */
\ No newline at end of file
+#endif /* SOLUTION_STACK_H */
@@ -1,71 +1,823 @@
 #include <assert.h>
 #include <math.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include "dlinks_parallel.h"
 #include "sudoku_core.h"
+#include "sudoku_kernels.h"
 
-// Constraint calculation functions
-static inline int one_constraint(int row, int dim) {
-    return row / dim;
+// Largest dimension whose full candidate matrix is cached as a template
+#define TEMPLATE_MAX_DIM 25
+
+// Rows per cell a search may try, times the Luby term of the attempt, before it restarts in another order
+#define RESTART_NODES_PER_CELL 64
+
+// Full candidate matrix of each dimension, built on first use
+static Matrix* matrix_templates[TEMPLATE_MAX_DIM + 1];
+
+// Four constraint columns of every placement of each dimension, built on first use
+static int (*column_tables[TEMPLATE_MAX_DIM + 1])[4];
+
+// Guards matrix_templates and column_tables, so puzzles can be converted from several threads
+static pthread_mutex_t template_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Most puzzles a solve_many worker takes from the shared queue at a time
+#define SOLVE_MANY_CHUNK 16
+
+/**
+ * @brief Work shared by the threads of one solve_many or count_many call
+ *
+ * counts selects the job: NULL to solve every puzzle into solutions, or an
+ * array receiving the solution count of every puzzle up to limit.
+ */
+typedef struct {
+    const int* puzzles;
+    int* solutions;
+    search_status* status;
+    long long* counts;
+    long long limit;
+    const Matrix* template;     // Full candidate matrix, or NULL past TEMPLATE_MAX_DIM
+    int num_puzzles, dim;
+    int chunk;                  // Puzzles taken from the queue at a time
+    int next;                   // First puzzle not handed out yet, taken atomically
+    int solved;                 // Puzzles solved (or with a solution) so far, added to atomically
+} puzzle_batch;
+
+/**
+ * @brief Code paths specialized for one dimension
+ *
+ * Each function is a generic helper instantiated with dim and box_size as
+ * compile-time constants, so its divisions fold into multiplications and
+ * its loops get constant bounds.
+ */
+typedef struct {
+    int dim;
+    void (*fill_columns)(int (*columns)[4]);                   // See fill_column_table
+    void (*decode)(Node* const* nodes, int count, int* board);  // See decode_placements
+    bool (*validate)(const int* board);                         // See validate_units
+} constraint_kernel;
+
+// Forward declarations of helper functions
+static const constraint_kernel* constraint_kernel_for(int dim);
+static const int (*column_table(int dim))[4];
+static inline void placement_columns(int placement, int dim, int box_size, int* cols);
+static inline void fill_column_table(int (*columns)[4], int dim, int box_size);
+static inline void decode_placements(Node* const* nodes, int count, int dim, int* board);
+static inline bool validate_units(const int* board, int dim, int box_size);
+static int box_size_of(int dim);
+static Matrix* build_pruned_matrix(const int* sudoku_list, int dim, uint32_t seed);
+static IndexMatrix* build_index_matrix(const int* sudoku_list, int dim, uint32_t seed);
+static int* open_placements(const int* sudoku_list, int dim, int* num_givens, int* num_open);
+static void shuffle_order(int* rows, int num_rows, int* col_ids, int num_cols, uint32_t seed);
+static inline const int* cell_columns(const int (*columns)[4], int dim, int box_size, int cell, int* scratch);
+static inline bool placement_open(const unsigned char* used, const int* cols, int v);
+static inline void mark_placement(unsigned char* used, const int* cols, int v);
+static search_status search_restarts(Matrix* matrix, const int* sudoku_list, int dim, long long budget, int* solution);
+static search_status index_search_restarts(IndexMatrix* matrix, const int* sudoku_list, int dim, long long budget, int* solution);
+static long long restart_unit(const int* sudoku_list, int dim);
+static long long luby(long long i);
+static inline uint32_t next_seed(uint32_t seed);
+static bool cover_givens(Matrix* matrix, const int* sudoku_list, int dim);
+static void decode_solution(const Matrix* matrix, int dim, int* solution);
+static void decode_index_solution(const IndexMatrix* matrix, int dim, int* solution);
+static search_status solve_on_pointer(const int* puzzle, int dim, int* solution, long long budget, solve_stats* stats);
+static search_status solve_on_index(const int* puzzle, int dim, int* solution, long long budget, solve_stats* stats);
+static search_status solve_with_context(Matrix* context, const puzzle_batch* batch, int index);
+static void run_batch(puzzle_batch* batch, int num_threads);
+static void* solve_batch(void* arg);
+static long long count_with_context(Matrix* context, const puzzle_batch* batch, int index);
+static double now_us(void);
+
+// Instantiates the constraint kernel of dimension D, whose boxes are B x B
+#define CONSTRAINT_KERNEL(D, B) \
+    static void fill_columns_##D(int (*columns)[4]) { fill_column_table(columns, D, B); } \
+    static void decode_##D(Node* const* nodes, int count, int* board) { decode_placements(nodes, count, D, board); } \
+    static bool validate_##D(const int* board) { return validate_units(board, D, B); }
+
+CONSTRAINT_KERNEL(4, 2)
+CONSTRAINT_KERNEL(9, 3)
+CONSTRAINT_KERNEL(16, 4)
+CONSTRAINT_KERNEL(25, 5)
+
+// Dimensions with specialized code paths; any other goes through the generic helpers
+static const constraint_kernel constraint_kernels[] = {
+    { 4, fill_columns_4, decode_4, validate_4 },
+    { 9, fill_columns_9, decode_9, validate_9 },
+    { 16, fill_columns_16, decode_16, validate_16 },
+    { 25, fill_columns_25, decode_25, validate_25 }
+};
+
+/**
+ * @brief Looks up the specialized code paths of a dimension
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @return Pointer to the kernel, or NULL if dim has none
+ */
+static const constraint_kernel* constraint_kernel_for(int dim) {
+    int count = (int)(sizeof(constraint_kernels) / sizeof(constraint_kernels[0]));
+    for (int i = 0; i < count; i++) {
+        if (constraint_kernels[i].dim == dim) return &constraint_kernels[i];
+    }
+    
+    return NULL;
+}
+
+/**
+ * @brief Returns the cached constraint columns of every placement of a dimension, building them on first use
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @return dim³ rows of four columns indexed by placement, or NULL if dim is too large to cache or out of memory
+ */
+static const int (*column_table(int dim))[4] {
+    if (dim < 1 || dim > TEMPLATE_MAX_DIM) return NULL;
+    
+    pthread_mutex_lock(&template_lock);
+    if (!column_tables[dim]) {
+        int (*columns)[4] = (int (*)[4])malloc(sizeof(int[4]) * dim * dim * dim);
+        const constraint_kernel* kernel = constraint_kernel_for(dim);
+        if (columns && kernel) {
+            kernel->fill_columns(columns);
+        } else if (columns) {
+            fill_column_table(columns, dim, box_size_of(dim));
+        }
+        column_tables[dim] = columns;
+    }
+    const int (*columns)[4] = (const int (*)[4])column_tables[dim];
+    pthread_mutex_unlock(&template_lock);
+    
+    return columns;
 }
 
-static inline int row_constraint(int row, int dim) {
-    return (dim * dim) + dim * (row / (dim * dim)) + (row % dim);
+/**
+ * @brief Computes the four constraint columns of one placement
+ *
+ * The columns are, in increasing order, the cell, then the value in the
+ * cell's row, in its column and in its box.
+ *
+ * @param placement Placement (cell * dim + value - 1)
+ * @param dim Dimension of the puzzle
+ * @param box_size Side of the boxes
+ * @param cols Receives the four columns
+ */
+static inline void placement_columns(int placement, int dim, int box_size, int* cols) {
+    int num_cells = dim * dim;
+    int cell = placement / dim, v = placement % dim;
+    int r = cell / dim, c = cell % dim, b = (r / box_size) * box_size + c / box_size;
+    
+    cols[0] = cell;
+    cols[1] = num_cells + r * dim + v;
+    cols[2] = 2 * num_cells + c * dim + v;
+    cols[3] = 3 * num_cells + b * dim + v;
 }
 
-static inline int col_constraint(int row, int dim) {
-    return 2 * (dim * dim) + (row % (dim * dim));
+/**
+ * @brief Fills the constraint columns of every placement of a dimension
+ *
+ * Walks the cells by row and column, so no placement needs dividing.
+ *
+ * @param columns Array of dim³ rows of four columns, indexed by placement
+ * @param dim Dimension of the puzzle
+ * @param box_size Side of the boxes
+ */
+static inline void fill_column_table(int (*columns)[4], int dim, int box_size) {
+    int num_cells = dim * dim;
+    
+    for (int r = 0; r < dim; r++) {
+        for (int c = 0; c < dim; c++) {
+            int cell = r * dim + c, b = (r / box_size) * box_size + c / box_size;
+            for (int v = 0; v < dim; v++) {
+                int* cols = columns[cell * dim + v];
+                cols[0] = cell;
+                cols[1] = num_cells + r * dim + v;
+                cols[2] = 2 * num_cells + c * dim + v;
+                cols[3] = 3 * num_cells + b * dim + v;
+            }
+        }
+    }
 }
 
-static inline int box_constraint(int row, int dim) {
-    int box_size = (int)sqrt(dim);
-    return 3 * (dim * dim) + 
-           (row / (box_size * dim * dim)) * (dim * box_size) +
-           ((row / (box_size * dim)) % box_size) * dim + 
-           (row % dim);
+/**
+ * @brief Writes chosen rows into a board from the placement their nodes hold
+ * @param nodes One node of each chosen row
+ * @param count Number of chosen rows
+ * @param dim Dimension of the puzzle
+ * @param board Board receiving the values
+ */
+static inline void decode_placements(Node* const* nodes, int count, int dim, int* board) {
+    for (int i = 0; i < count; i++) {
+        int placement = nodes[i]->value;
+        board[placement / dim] = (placement % dim) + 1;
+    }
+}
+
+/**
+ * @brief Checks that a board is completely and correctly filled, one value mask per unit
+ *
+ * Every cell is ORed into its row, column and box without branching, and
+ * each unit must end up holding all dim values.
+ *
+ * @param board Array of dim * dim cells
+ * @param dim Dimension of the board, at most 25
+ * @param box_size Side of the boxes
+ * @return true if every row, column and box holds each value exactly once
+ */
+static inline bool validate_units(const int* board, int dim, int box_size) {
+    uint32_t rows[TEMPLATE_MAX_DIM] = {0}, cols[TEMPLATE_MAX_DIM] = {0}, boxes[TEMPLATE_MAX_DIM] = {0};
+    unsigned out_of_range = 0;
+    
+    for (int r = 0; r < dim; r++) {
+        for (int c = 0; c < dim; c++) {
+            unsigned value = (unsigned)board[r * dim + c];
+            out_of_range |= value - 1 >= (unsigned)dim;
+            
+            uint32_t bit = 1u << (value & 31);
+            rows[r] |= bit;
+            cols[c] |= bit;
+            boxes[(r / box_size) * box_size + c / box_size] |= bit;
+        }
+    }
+    
+    // dim cells cover all dim values only if no value repeats
+    uint32_t full = ((1u << dim) - 1) << 1, all = full;
+    for (int u = 0; u < dim; u++) {
+        all &= rows[u] & cols[u] & boxes[u];
+    }
+    
+    return !out_of_range && all == full;
+}
+
+/**
+ * @brief Computes the side of the boxes of a dimension
+ * @param dim Dimension of the puzzle, a perfect square
+ * @return Side of the boxes
+ */
+static int box_size_of(int dim) {
+    return (int)(sqrt((double)dim) + 0.5);
+}
+
+/**
+ * @brief Builds the full candidate matrix of a dimension node by node
+ *
+ * Row r is the placement of value r % dim + 1 in cell r / dim, and every
+ * node holds its row's placement as its value.
+ *
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param columns Constraint columns of every placement (see column_table)
+ * @return Pointer to the constraint matrix
+ */
+static Matrix* build_matrix(int dim, const int (*columns)[4]) {
+    int num_rows = dim * dim * dim;
+    int num_cols = dim * dim * 4;
+    
+    // Size the node arena exactly: four constraint nodes per candidate row
+    Matrix* matrix = create_matrix_sized(num_rows, num_cols, num_rows * 4);
+    if (!matrix) return NULL;
+
+    // Rows are produced in increasing order and the four constraint columns of
+    // a row are increasing too, so every node can be appended at the tail
+    for (int row = 0; row < num_rows; row++) {
+        for (int i = 0; i < 4; i++) {
+            append_node(matrix, row, columns[row][i], row);
+        }
+    }
+    
+    return matrix;
+}
+
+/**
+ * @brief Builds the constraint matrix of only the placements a puzzle leaves open
+ *
+ * Candidates ruled out by a given in the same row, column or box get no
+ * row, so the matrix grows with the open candidates rather than with dim³.
+ * Rows are numbered compactly: the givens first, already covered, then the
+ * open candidates. Every node holds its row's placement (cell * dim + value
+ * - 1) as its value for decoding. A nonzero seed shuffles the order of the
+ * open rows and of the columns, so the search tries them in another order.
+ *
+ * @param sudoku_list Array representing the Sudoku puzzle (0 for empty cells)
+ * @param dim Dimension of the puzzle (e.g., 25 for a 25x25 puzzle)
+ * @param seed Shuffle seed, 0 to keep rows and columns in placement order
+ * @return Pointer to the constraint matrix, or NULL if the givens contradict each other or out of memory
+ */
+static Matrix* build_pruned_matrix(const int* sudoku_list, int dim, uint32_t seed) {
+    int num_cols = dim * dim * 4;
+    int num_givens, num_open;
+    
+    int box_size = box_size_of(dim);
+    const int (*columns)[4] = column_table(dim);
+    
+    int* placements = open_placements(sudoku_list, dim, &num_givens, &num_open);
+    int* col_ids = (int*)malloc(sizeof(int) * num_cols);
+    if (!placements || !col_ids) {
+        free(placements);
+        free(col_ids);
+        return NULL;
+    }
+    
+    shuffle_order(placements + num_givens, num_open, col_ids, num_cols, seed);
+    
+    int num_rows = num_givens + num_open;
+    Matrix* matrix = create_matrix_sized(num_rows, num_cols, num_rows * 4);
+    
+    // Rows are appended in order, each with its columns sorted, so every node goes at the tail
+    for (int row = 0; matrix && row < num_rows; row++) {
+        int placement = placements[row];
+        int cols[4];
+        if (columns) {
+            memcpy(cols, columns[placement], sizeof(cols));
+        } else {
+            placement_columns(placement, dim, box_size, cols);
+        }
+        for (int i = 0; i < 4; i++) {
+            cols[i] = col_ids[cols[i]];
+        }
+        
+        for (int i = 1; i < 4; i++) {
+            for (int j = i; j > 0 && cols[j - 1] > cols[j]; j--) {
+                int temp = cols[j];
+                cols[j] = cols[j - 1];
+                cols[j - 1] = temp;
+            }
+        }
+        
+        for (int i = 0; i < 4; i++) {
+            append_node(matrix, row, cols[i], placement);
+        }
+    }
+    
+    // Givens were checked against each other, so covering them cannot fail
+    for (int row = 0; matrix && row < num_givens; row++) {
+        cover_row(matrix, row);
+    }
+    
+    free(placements);
+    free(col_ids);
+    return matrix;
+}
+
+/**
+ * @brief Lists the placements of the givens of a puzzle and of the candidates they leave open
+ * @param sudoku_list Array representing the Sudoku puzzle (0 for empty cells)
+ * @param dim Dimension of the puzzle (e.g., 25 for a 25x25 puzzle)
+ * @param num_givens Receives the number of givens, listed first in cell order
+ * @param num_open Receives the number of open candidates, listed after the givens in placement order
+ * @return Array of the placements (free with free()), or NULL if the givens contradict each other,
+ *         a cell is out of range or out of memory
+ */
+static int* open_placements(const int* sudoku_list, int dim, int* num_givens, int* num_open) {
+    int num_cells = dim * dim;
+    int box_size = box_size_of(dim);
+    const int (*columns)[4] = column_table(dim);
+    int scratch[4];
+    
+    // One flag per constraint column, of which the row, column and box ones are used
+    unsigned char* used = (unsigned char*)calloc((size_t)num_cells * 4, 1);
+    if (!used) return NULL;
+    
+    int givens = 0;
+    for (int i = 0; i < num_cells; i++) {
+        int value = sudoku_list[i];
+        if (value < 0 || value > dim) {
+            free(used);
+            return NULL;
+        }
+        if (value == 0) continue;
+        
+        const int* cols = cell_columns(columns, dim, box_size, i, scratch);
+        if (!placement_open(used, cols, value - 1)) {
+            free(used);
+            return NULL;
+        }
+        mark_placement(used, cols, value - 1);
+        givens++;
+    }
+    
+    // Count the open candidates first, so the list is allocated at its exact size
+    int open = 0;
+    for (int i = 0; i < num_cells; i++) {
+        if (sudoku_list[i] != 0) continue;
+        
+        const int* cols = cell_columns(columns, dim, box_size, i, scratch);
+        for (int v = 0; v < dim; v++) {
+            if (placement_open(used, cols, v)) open++;
+        }
+    }
+    
+    int* placements = (int*)malloc(sizeof(int) * (size_t)(givens + open > 0 ? givens + open : 1));
+    if (!placements) {
+        free(used);
+        return NULL;
+    }
+    
+    int g = 0, k = givens;
+    for (int i = 0; i < num_cells; i++) {
+        if (sudoku_list[i] != 0) {
+            placements[g++] = i * dim + sudoku_list[i] - 1;
+            continue;
+        }
+        
+        const int* cols = cell_columns(columns, dim, box_size, i, scratch);
+        for (int v = 0; v < dim; v++) {
+            if (placement_open(used, cols, v)) placements[k++] = i * dim + v;
+        }
+    }
+    
+    free(used);
+    *num_givens = givens;
+    *num_open = open;
+    return placements;
+}
+
+/**
+ * @brief Numbers the columns in order, then shuffles the open rows and the column ids under a seed
+ * @param rows Open rows (placements) to shuffle
+ * @param num_rows Number of open rows
+ * @param col_ids num_cols entries receiving the id each column is renumbered to
+ * @param num_cols Number of columns
+ * @param seed Shuffle seed, 0 to keep rows and columns in order
+ */
+static void shuffle_order(int* rows, int num_rows, int* col_ids, int num_cols, uint32_t seed) {
+    for (int c = 0; c < num_cols; c++) {
+        col_ids[c] = c;
+    }
+    
+    // Fisher-Yates on the open rows and the column ids
+    for (int i = num_rows - 1; seed && i > 0; i--) {
+        seed = next_seed(seed);
+        int j = (int)(seed % (uint32_t)(i + 1));
+        int temp = rows[i];
+        rows[i] = rows[j];
+        rows[j] = temp;
+    }
+    for (int i = num_cols - 1; seed && i > 0; i--) {
+        seed = next_seed(seed);
+        int j = (int)(seed % (uint32_t)(i + 1));
+        int temp = col_ids[i];
+        col_ids[i] = col_ids[j];
+        col_ids[j] = temp;
+    }
+}
+
+/**
+ * @brief Returns the constraint columns of the first value of a cell
+ *
+ * The row, column and box columns of value v + 1 follow at offset v.
+ *
+ * @param columns Column table of the dimension, or NULL to compute the columns
+ * @param dim Dimension of the puzzle
+ * @param box_size Side of the boxes
+ * @param cell Cell index
+ * @param scratch Four ints receiving the columns when there is no table
+ * @return The four columns
+ */
+static inline const int* cell_columns(const int (*columns)[4], int dim, int box_size, int cell, int* scratch) {
+    if (columns) return columns[cell * dim];
+    
+    placement_columns(cell * dim, dim, box_size, scratch);
+    return scratch;
+}
+
+/**
+ * @brief Checks that no given shares a row, column or box with a placement and has its value
+ * @param used Flags of open_placements, one per constraint column
+ * @param cols Constraint columns of the cell's first value (see cell_columns)
+ * @param v Value minus one
+ * @return true if the placement is still open
+ */
+static inline bool placement_open(const unsigned char* used, const int* cols, int v) {
+    return !used[cols[1] + v] && !used[cols[2] + v] && !used[cols[3] + v];
+}
+
+/**
+ * @brief Marks the value of a given as used in its row, column and box
+ * @param used Flags of open_placements, one per constraint column
+ * @param cols Constraint columns of the given's cell's first value (see cell_columns)
+ * @param v Value of the given minus one
+ */
+static inline void mark_placement(unsigned char* used, const int* cols, int v) {
+    used[cols[1] + v] = used[cols[2] + v] = used[cols[3] + v] = 1;
+}
+
+/**
+ * @brief Returns the cached full candidate matrix for a dimension, building it on first use
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @return Pointer to the template, or NULL if dim is too large to cache
+ */
+static Matrix* matrix_template(int dim) {
+    if (dim < 1 || dim > TEMPLATE_MAX_DIM) return NULL;
+    
+    const int (*columns)[4] = column_table(dim);
+    if (!columns) return NULL;
+    
+    // Templates are only read once built, so the lock just covers the lookup
+    pthread_mutex_lock(&template_lock);
+    if (!matrix_templates[dim]) {
+        matrix_templates[dim] = build_matrix(dim, columns);
+    }
+    Matrix* template = matrix_templates[dim];
+    pthread_mutex_unlock(&template_lock);
+    
+    return template;
 }
 
 /**
  * @brief Converts a Sudoku puzzle into a constraint matrix for Algorithm X
+ *
+ * The full candidate matrix of the dimension is cloned from a cached
+ * template and the rows of the givens are then covered, so only the empty
+ * cells are left for the search. Past TEMPLATE_MAX_DIM the matrix holds
+ * only the candidates the givens leave open instead.
+ *
  * @param sudoku_list Array representing the Sudoku puzzle (0 for empty cells)
  * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
- * @return Pointer to the constraint matrix
+ * @return Pointer to the constraint matrix, or NULL if the givens contradict each other or a cell is out of range
  */
 Matrix* puzzle_to_matrix(const int* sudoku_list, int dim) {
     assert((int)sqrt(dim) * (int)sqrt(dim) == dim); // Only perfect square puzzles are supported
     
-    int num_rows = dim * dim * dim;
-    int num_cols = dim * dim * 4;
-    int num_cells = dim * dim;
+    Matrix* template = matrix_template(dim);
+    if (!template) return build_pruned_matrix(sudoku_list, dim, 0);
     
-    Matrix* matrix = create_matrix(num_rows, num_cols);
+    Matrix* matrix = clone_matrix(template);
     if (!matrix) return NULL;
+    
+    if (!cover_givens(matrix, sudoku_list, dim)) {
+        delete_matrix(matrix);
+        return NULL;
+    }
+    
+    return matrix;
+}
 
-    int row = 0;
-    // Iterate through puzzle list
+/**
+ * @brief Covers the row of every given of a puzzle in a full candidate matrix
+ * @param matrix Pointer to a copy of the template of the dimension
+ * @param sudoku_list Array representing the Sudoku puzzle (0 for empty cells)
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @return true on success, false if the givens contradict each other or a cell is out of range
+ */
+static bool cover_givens(Matrix* matrix, const int* sudoku_list, int dim) {
+    int num_cells = dim * dim;
+    
+    // A value past dim would name a row of another cell, so reject it before covering anything
     for (int i = 0; i < num_cells; i++) {
-        // If no value assigned to cell, populate all rows representing all possible candidate values for cell
-        if (sudoku_list[i] == 0) {
-            for (int j = 0; j < dim; j++) {
-                row = i * dim + j;
-                insert_node(matrix, row, one_constraint(row, dim), 1);
-                insert_node(matrix, row, row_constraint(row, dim), 1);
-                insert_node(matrix, row, col_constraint(row, dim), 1);
-                insert_node(matrix, row, box_constraint(row, dim), 1);
-            }
+        if (sudoku_list[i] < 0 || sudoku_list[i] > dim) return false;
+    }
+    
+    for (int i = 0; i < num_cells; i++) {
+        if (sudoku_list[i] == 0) continue;
+        
+        // Two givens sharing a row, column or box leave no exact cover
+        if (!cover_row(matrix, i * dim + sudoku_list[i] - 1)) return false;
+    }
+    
+    return true;
+}
+
+/**
+ * @brief Writes the rows on the solution stack of a solved matrix into a board
+ * @param matrix Pointer to the solved matrix
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param solution Board already holding the givens
+ */
+static void decode_solution(const Matrix* matrix, int dim, int* solution) {
+    const constraint_kernel* kernel = constraint_kernel_for(dim);
+    Node* const* nodes = (Node* const*)matrix->solution->items;
+    
+    // Nodes hold the placement of their row, whatever the row numbering
+    if (kernel) {
+        kernel->decode(nodes, matrix->solution->count, solution);
+    } else {
+        decode_placements(nodes, matrix->solution->count, dim, solution);
+    }
+}
+
+/**
+ * @brief Writes the rows of a solved index matrix into a board
+ * @param matrix Pointer to the solved matrix, row indices left in matrix->solution
+ * @param dim Dimension of the puzzle (e.g., 36 for a 36x36 puzzle)
+ * @param solution Board already holding the givens
+ */
+static void decode_index_solution(const IndexMatrix* matrix, int dim, int* solution) {
+    for (int i = 0; i < matrix->solution_count; i++) {
+        int placement = matrix->row_value[matrix->solution[i]];
+        solution[placement / dim] = (placement % dim) + 1;
+    }
+}
+
+/**
+ * @brief Searches a puzzle's matrix, restarting on reshuffled matrices when a search runs long
+ *
+ * Searches on large grids have a heavy tail: an early wrong guess can take
+ * far longer to refute than another order takes to find a solution. Attempt
+ * i may try RESTART_NODES_PER_CELL rows per empty cell times the i-th Luby
+ * term before the puzzle is rebuilt with build_pruned_matrix under a new
+ * seed. The Luby terms keep most attempts short while every length keeps
+ * recurring, so a run still ends either solved or with a complete search
+ * proving there is no solution.
+ *
+ * @param matrix Constraint matrix of the puzzle, left as it was found unless solved
+ * @param sudoku_list Array representing the Sudoku puzzle (0 for empty cells)
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param budget Maximum number of candidate placements to try over all searches, 0 or less for no limit
+ * @param solution Board already holding the givens, receives the solution
+ * @return SEARCH_SOLVED, SEARCH_UNSAT or SEARCH_BUDGET_EXHAUSTED
+ */
+static search_status search_restarts(Matrix* matrix, const int* sudoku_list, int dim, long long budget, int* solution) {
+    long long unit = restart_unit(sudoku_list, dim);
+    uint32_t seed = (uint32_t)dim;
+    Matrix* current = matrix;
+    search_status status;
+    
+    for (long long attempt = 1;; attempt++) {
+        long long limit = unit * luby(attempt);
+        long long nodes = (budget > 0 && budget < limit) ? budget : limit;
+        
+        status = alg_x_search_budget(current, nodes);
+        if (status == SEARCH_SOLVED) decode_solution(current, dim, solution);
+        if (status != SEARCH_BUDGET_EXHAUSTED || (budget > 0 && (budget -= nodes) <= 0)) break;
+        
+        // The caller's matrix is left alone, only reshuffled copies are replaced;
+        // without memory for a copy the same one is searched again
+        seed = next_seed(seed);
+        Matrix* next = build_pruned_matrix(sudoku_list, dim, seed);
+        if (next) {
+            next->stats = matrix->stats;
+            next->stop = matrix->stop;
+            if (current != matrix) delete_matrix(current);
+            current = next;
         }
-        // Otherwise only populate the row representing the known assigned value
-        else {
-            row = i * dim + sudoku_list[i] - 1;
-            insert_node(matrix, row, one_constraint(row, dim), 1);
-            insert_node(matrix, row, row_constraint(row, dim), 1);
-            insert_node(matrix, row, col_constraint(row, dim), 1);
-            insert_node(matrix, row, box_constraint(row, dim), 1);
+    }
+    
+    if (current != matrix) delete_matrix(current);
+    return status;
+}
+
+/**
+ * @brief Searches a puzzle's index matrix, restarting on reshuffled matrices when a search runs long
+ *
+ * The index counterpart of search_restarts, with the same Luby schedule;
+ * restarts rebuild the puzzle with build_index_matrix under a new seed.
+ *
+ * @param matrix Index constraint matrix of the puzzle, left as it was found unless solved
+ * @param sudoku_list Array representing the Sudoku puzzle (0 for empty cells)
+ * @param dim Dimension of the puzzle (e.g., 36 for a 36x36 puzzle)
+ * @param budget Maximum number of candidate placements to try over all searches, 0 or less for no limit
+ * @param solution Board already holding the givens, receives the solution
+ * @return SEARCH_SOLVED, SEARCH_UNSAT or SEARCH_BUDGET_EXHAUSTED
+ */
+static search_status index_search_restarts(IndexMatrix* matrix, const int* sudoku_list, int dim, long long budget, int* solution) {
+    long long unit = restart_unit(sudoku_list, dim);
+    uint32_t seed = (uint32_t)dim;
+    IndexMatrix* current = matrix;
+    search_status status;
+    
+    for (long long attempt = 1;; attempt++) {
+        long long limit = unit * luby(attempt);
+        long long nodes = (budget > 0 && budget < limit) ? budget : limit;
+        
+        status = index_alg_x_search_budget(current, nodes);
+        if (status == SEARCH_SOLVED) decode_index_solution(current, dim, solution);
+        if (status != SEARCH_BUDGET_EXHAUSTED || (budget > 0 && (budget -= nodes) <= 0)) break;
+        
+        // The caller's matrix is left alone, only reshuffled copies are replaced;
+        // without memory for a copy the same one is searched again
+        seed = next_seed(seed);
+        IndexMatrix* next = build_index_matrix(sudoku_list, dim, seed);
+        if (next) {
+            next->stats = matrix->stats;
+            if (current != matrix) delete_index_matrix(current);
+            current = next;
         }
     }
     
+    if (current != matrix) delete_index_matrix(current);
+    return status;
+}
+
+/**
+ * @brief Rows a restarting search may try per Luby term: RESTART_NODES_PER_CELL per empty cell
+ * @param sudoku_list Array representing the Sudoku puzzle (0 for empty cells)
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @return Search tree nodes of an attempt whose Luby term is 1
+ */
+static long long restart_unit(const int* sudoku_list, int dim) {
+    int empty = 0;
+    for (int i = 0; i < dim * dim; i++) {
+        if (sudoku_list[i] == 0) empty++;
+    }
+    
+    return (long long)(empty > 0 ? empty : 1) * RESTART_NODES_PER_CELL;
+}
+
+/**
+ * @brief Term of the Luby sequence 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, 1, 1, 2, 4, 8, ...
+ * @param i Position in the sequence, from 1
+ * @return The i-th term
+ */
+static long long luby(long long i) {
+    for (;;) {
+        int k = 1;
+        while ((1LL << k) - 1 < i) k++;
+        
+        // A run of 2^k - 1 terms ends in 2^(k-1) and otherwise repeats the run before it
+        if ((1LL << k) - 1 == i) return 1LL << (k - 1);
+        i -= (1LL << (k - 1)) - 1;
+    }
+}
+
+/**
+ * @brief Steps a xorshift32 generator
+ * @param seed Current state, not 0
+ * @return Next state, not 0
+ */
+static inline uint32_t next_seed(uint32_t seed) {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+/**
+ * @brief Frees the cached template matrices and column tables
+ */
+void free_matrix_templates(void) {
+    pthread_mutex_lock(&template_lock);
+    for (int dim = 0; dim <= TEMPLATE_MAX_DIM; dim++) {
+        delete_matrix(matrix_templates[dim]);
+        matrix_templates[dim] = NULL;
+        free(column_tables[dim]);
+        column_tables[dim] = NULL;
+    }
+    pthread_mutex_unlock(&template_lock);
+}
+
+/**
+ * @brief Converts a Sudoku puzzle into an index based constraint matrix for Algorithm X
+ * @param sudoku_list Array representing the Sudoku puzzle (0 for empty cells)
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @return Pointer to the constraint matrix, or NULL if the givens contradict each other
+ */
+IndexMatrix* puzzle_to_index_matrix(const int* sudoku_list, int dim) {
+    assert((int)sqrt(dim) * (int)sqrt(dim) == dim); // Only perfect square puzzles are supported
+    return build_index_matrix(sudoku_list, dim, 0);
+}
+
+/**
+ * @brief Builds the index based constraint matrix of only the placements a puzzle leaves open
+ *
+ * The index counterpart of build_pruned_matrix: the givens' rows come first
+ * and are covered, row_value holds the placement (cell * dim + value - 1) of
+ * each row, and a nonzero seed shuffles the open rows and the columns.
+ *
+ * @param sudoku_list Array representing the Sudoku puzzle (0 for empty cells)
+ * @param dim Dimension of the puzzle (e.g., 36 for a 36x36 puzzle)
+ * @param seed Shuffle seed, 0 to keep rows and columns in placement order
+ * @return Pointer to the constraint matrix, or NULL if the givens contradict each other or out of memory
+ */
+static IndexMatrix* build_index_matrix(const int* sudoku_list, int dim, uint32_t seed) {
+    int num_cols = dim * dim * 4;
+    int num_givens, num_open;
+    int box_size = box_size_of(dim);
+    const int (*columns)[4] = column_table(dim);
+    
+    int* placements = open_placements(sudoku_list, dim, &num_givens, &num_open);
+    int* col_ids = (int*)malloc(sizeof(int) * num_cols);
+    if (!placements || !col_ids) {
+        free(placements);
+        free(col_ids);
+        return NULL;
+    }
+    
+    shuffle_order(placements + num_givens, num_open, col_ids, num_cols, seed);
+    
+    int num_rows = num_givens + num_open;
+    IndexMatrix* matrix = create_index_matrix(num_rows > 0 ? num_rows : 1, num_cols, num_rows * 4);
+    
+    // Every node goes at the tail of its row and column, the givens' rows first
+    for (int row = 0; matrix && row < num_rows; row++) {
+        int placement = placements[row];
+        int cols[4];
+        if (columns) {
+            memcpy(cols, columns[placement], sizeof(cols));
+        } else {
+            placement_columns(placement, dim, box_size, cols);
+        }
+        
+        for (int j = 0; j < 4; j++) {
+            index_append_node(matrix, row, col_ids[cols[j]]);
+        }
+        matrix->row_value[row] = placement;
+    }
+    
+    // Givens were checked against each other, so covering them cannot fail
+    for (int row = 0; matrix && row < num_givens; row++) {
+        index_cover_row(matrix, row);
+    }
+    
+    free(placements);
+    free(col_ids);
     return matrix;
 }
 
@@ -77,28 +829,301 @@ Matrix* puzzle_to_matrix(const int* sudoku_list, int dim) {
  * @return true if a solution is found, false otherwise
  */
 bool solve_puzzle(const int* puzzle, int dim, int* solution) {
+    return solve_puzzle_budget(puzzle, dim, solution, 0) == SEARCH_SOLVED;
+}
+
+/**
+ * @brief Solves a Sudoku puzzle with the chosen matrix representation
+ * @param puzzle Array representing the initial Sudoku puzzle (0 for empty cells)
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param solution Array to store the solution (must be pre-allocated)
+ * @param engine Matrix representation to search with
+ * @return true if a solution is found, false otherwise
+ */
+bool solve_puzzle_with_engine(const int* puzzle, int dim, int* solution, solver_engine engine) {
     if (!puzzle || !solution) return false;
     
+    search_status status = engine == SOLVER_ENGINE_INDEX
+        ? solve_on_index(puzzle, dim, solution, 0, NULL)
+        : solve_on_pointer(puzzle, dim, solution, 0, NULL);
+    return status == SEARCH_SOLVED;
+}
+
+/**
+ * @brief Solves a Sudoku puzzle, giving up after a fixed amount of search
+ * @param puzzle Array representing the initial Sudoku puzzle (0 for empty cells)
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param solution Array to store the solution (must be pre-allocated)
+ * @param budget Maximum number of candidate placements to try, 0 or less for no limit
+ * @return SEARCH_SOLVED, SEARCH_UNSAT (also for contradictory or out of range givens) or SEARCH_BUDGET_EXHAUSTED
+ */
+search_status solve_puzzle_budget(const int* puzzle, int dim, int* solution, long long budget) {
+    return solve_puzzle_stats(puzzle, dim, solution, budget, NULL);
+}
+
+/**
+ * @brief Solves a Sudoku puzzle and reports the work the search took
+ *
+ * Grids up to TEMPLATE_MAX_DIM are searched on the pointer engine, whose
+ * cached templates make them cheap to set up; larger ones on the index
+ * engine, whose 24-byte nodes keep their matrices small.
+ *
+ * @param puzzle Array representing the initial Sudoku puzzle (0 for empty cells)
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param solution Array to store the solution (must be pre-allocated)
+ * @param budget Maximum number of candidate placements to try, 0 or less for no limit
+ * @param stats Receives the search counters and timings, or NULL
+ * @return SEARCH_SOLVED, SEARCH_UNSAT (also for contradictory or out of range givens) or SEARCH_BUDGET_EXHAUSTED
+ */
+search_status solve_puzzle_stats(const int* puzzle, int dim, int* solution, long long budget, solve_stats* stats) {
+    if (stats) memset(stats, 0, sizeof(solve_stats));
+    if (!puzzle || !solution) return SEARCH_UNSAT;
+    
+    if (dim > TEMPLATE_MAX_DIM) return solve_on_index(puzzle, dim, solution, budget, stats);
+    return solve_on_pointer(puzzle, dim, solution, budget, stats);
+}
+
+/**
+ * @brief Solves a Sudoku puzzle on the pointer engine, restarting when a search runs long
+ * @param puzzle Array representing the initial Sudoku puzzle (0 for empty cells)
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param solution Array to store the solution (must be pre-allocated)
+ * @param budget Maximum number of candidate placements to try, 0 or less for no limit
+ * @param stats Receives the search counters and timings (already zeroed), or NULL
+ * @return SEARCH_SOLVED, SEARCH_UNSAT (also for contradictory or out of range givens) or SEARCH_BUDGET_EXHAUSTED
+ */
+static search_status solve_on_pointer(const int* puzzle, int dim, int* solution, long long budget, solve_stats* stats) {
+    double start = stats ? now_us() : 0;
+    
     // Copy puzzle to solution first
     memcpy(solution, puzzle, dim * dim * sizeof(int));
     
     Matrix* matrix = puzzle_to_matrix(puzzle, dim);
-    if (!matrix) return false;
+    if (stats) stats->build_us = now_us() - start;
+    if (!matrix) return SEARCH_UNSAT;
     
-    bool found = alg_x_search(matrix);
+    // Attached after the givens are covered, so only the search is counted
+    if (stats) {
+        matrix->stats = &stats->search;
+        start = now_us();
+    }
     
-    if (found) { // Decode solution stored in matrix.solution
-        int index, value;
-        for (solution_node* itr = matrix->solution->head; itr != NULL; itr = itr->next) {
-            Node* node = (Node*)itr->data;
-            index = node->row / dim;
-            value = (node->row % dim) + 1;
-            solution[index] = value;
-        }
+    search_status status = search_restarts(matrix, puzzle, dim, budget, solution);
+    
+    if (stats) stats->search_us = now_us() - start;
+    
+    delete_matrix(matrix);
+    return status;
+}
+
+/**
+ * @brief Solves a Sudoku puzzle on the index engine, restarting when a search runs long
+ * @param puzzle Array representing the initial Sudoku puzzle (0 for empty cells)
+ * @param dim Dimension of the puzzle (e.g., 36 for a 36x36 puzzle)
+ * @param solution Array to store the solution (must be pre-allocated)
+ * @param budget Maximum number of candidate placements to try, 0 or less for no limit
+ * @param stats Receives the search counters and timings (already zeroed), or NULL
+ * @return SEARCH_SOLVED, SEARCH_UNSAT (also for contradictory or out of range givens) or SEARCH_BUDGET_EXHAUSTED
+ */
+static search_status solve_on_index(const int* puzzle, int dim, int* solution, long long budget, solve_stats* stats) {
+    double start = stats ? now_us() : 0;
+    
+    // Copy puzzle to solution first
+    memcpy(solution, puzzle, dim * dim * sizeof(int));
+    
+    IndexMatrix* matrix = puzzle_to_index_matrix(puzzle, dim);
+    if (stats) stats->build_us = now_us() - start;
+    if (!matrix) return SEARCH_UNSAT;
+    
+    // Attached after the givens are covered, so only the search is counted
+    if (stats) {
+        matrix->stats = &stats->search;
+        start = now_us();
     }
     
+    search_status status = index_search_restarts(matrix, puzzle, dim, budget, solution);
+    
+    if (stats) stats->search_us = now_us() - start;
+    
+    delete_index_matrix(matrix);
+    return status;
+}
+
+/**
+ * @brief Solves a batch of Sudoku puzzles of one dimension across several threads
+ * @param puzzles n puzzles of dim * dim cells each, back to back (0 for empty cells)
+ * @param n Number of puzzles
+ * @param dim Dimension of the puzzles (e.g., 9 for 9x9 puzzles)
+ * @param solutions Array of n * dim * dim cells receiving the solutions (must be pre-allocated)
+ * @param status Array of n entries receiving SEARCH_SOLVED or SEARCH_UNSAT per puzzle, or NULL
+ * @param num_threads Number of threads to solve with, the calling thread included
+ * @return Number of puzzles solved
+ */
+int solve_many(const int* puzzles, int n, int dim, int* solutions, search_status* status, int num_threads) {
+    if (!puzzles || !solutions || n < 1) return 0;
+    
+    puzzle_batch batch = { puzzles, solutions, status, NULL, 0, NULL, n, dim, 0, 0, 0 };
+    run_batch(&batch, num_threads);
+    return batch.solved;
+}
+
+/**
+ * @brief Counts the solutions of a batch of Sudoku puzzles of one dimension across several threads
+ * @param puzzles n puzzles of dim * dim cells each, back to back (0 for empty cells)
+ * @param n Number of puzzles
+ * @param dim Dimension of the puzzles (e.g., 9 for 9x9 puzzles)
+ * @param limit Stop counting a puzzle after this many solutions, 0 or less for no limit
+ * @param counts Array of n entries receiving the solution count of each puzzle
+ * @param num_threads Number of threads to count with, the calling thread included
+ * @return Number of puzzles with at least one solution
+ */
+int count_many(const int* puzzles, int n, int dim, long long limit, long long* counts, int num_threads) {
+    if (!puzzles || !counts || n < 1) return 0;
+    
+    puzzle_batch batch = { puzzles, NULL, NULL, counts, limit, NULL, n, dim, 0, 0, 0 };
+    run_batch(&batch, num_threads);
+    return batch.solved;
+}
+
+/**
+ * @brief Counts the solutions of one Sudoku puzzle, splitting its search tree across several threads
+ * @param puzzle Array representing the initial Sudoku puzzle (0 for empty cells)
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param limit Stop after this many solutions, 0 or less for no limit
+ * @param num_threads Number of threads to count with, the calling thread included
+ * @return Number of solutions found, at most limit (0 for contradictory or out of range givens)
+ */
+long long count_solutions_parallel(const int* puzzle, int dim, long long limit, int num_threads) {
+    if (!puzzle) return 0;
+    if (num_threads <= 1) return count_solutions(puzzle, dim, limit);
+    
+    Matrix* matrix = puzzle_to_matrix(puzzle, dim);
+    if (!matrix) return 0;
+    
+    long long count = parallel_count(matrix, limit, num_threads);
+    
     delete_matrix(matrix);
-    return found;
+    return count;
+}
+
+/**
+ * @brief Runs the workers of a batch on the calling thread and num_threads - 1 more
+ * @param batch Batch to work through; its template, chunk and next are set here
+ * @param num_threads Number of threads, the calling thread included
+ */
+static void run_batch(puzzle_batch* batch, int num_threads) {
+    int n = batch->num_puzzles;
+    if (num_threads < 1) num_threads = 1;
+    if (num_threads > n) num_threads = n;
+    
+    // Small batches go out a puzzle or so at a time, so every thread gets some
+    batch->chunk = n / (num_threads * 4);
+    if (batch->chunk < 1) batch->chunk = 1;
+    if (batch->chunk > SOLVE_MANY_CHUNK) batch->chunk = SOLVE_MANY_CHUNK;
+    batch->next = 0;
+    
+    // Build the template before any worker starts copying it
+    batch->template = matrix_template(batch->dim);
+    
+    // The calling thread works too; threads that fail to start are simply missing
+    pthread_t* threads = (pthread_t*)malloc(sizeof(pthread_t) * num_threads);
+    bool* started = (bool*)calloc(num_threads, sizeof(bool));
+    
+    for (int i = 1; threads && started && i < num_threads; i++) {
+        started[i] = pthread_create(&threads[i], NULL, solve_batch, batch) == 0;
+    }
+    
+    solve_batch(batch);
+    
+    for (int i = 1; threads && started && i < num_threads; i++) {
+        if (started[i]) pthread_join(threads[i], NULL);
+    }
+    
+    free(started);
+    free(threads);
+}
+
+/**
+ * @brief solve_many and count_many worker: works through chunks of the batch until every puzzle has been handed out
+ *
+ * Each worker keeps one matrix for the whole batch and resets it from the
+ * template with copy_matrix before every puzzle, so apart from that first
+ * clone nothing is allocated per puzzle.
+ *
+ * @param arg Pointer to the puzzle_batch
+ * @return NULL
+ */
+static void* solve_batch(void* arg) {
+    puzzle_batch* batch = (puzzle_batch*)arg;
+    Matrix* context = batch->template ? clone_matrix(batch->template) : NULL;
+    int solved = 0;
+    
+    for (;;) {
+        int first = __atomic_fetch_add(&batch->next, batch->chunk, __ATOMIC_RELAXED);
+        if (first >= batch->num_puzzles) break;
+        
+        int last = first + batch->chunk;
+        if (last > batch->num_puzzles) last = batch->num_puzzles;
+        
+        for (int i = first; i < last; i++) {
+            if (batch->counts) {
+                batch->counts[i] = count_with_context(context, batch, i);
+                if (batch->counts[i] > 0) solved++;
+                continue;
+            }
+            
+            search_status status = solve_with_context(context, batch, i);
+            
+            if (batch->status) batch->status[i] = status;
+            if (status == SEARCH_SOLVED) solved++;
+        }
+    }
+    
+    __atomic_fetch_add(&batch->solved, solved, __ATOMIC_RELAXED);
+    delete_matrix(context);
+    return NULL;
+}
+
+/**
+ * @brief Solves one puzzle of a batch on a worker's reusable matrix
+ * @param context Worker's copy of the template, or NULL to build a matrix for the puzzle
+ * @param batch Batch the puzzle belongs to
+ * @param index Index of the puzzle in the batch
+ * @return SEARCH_SOLVED or SEARCH_UNSAT
+ */
+static search_status solve_with_context(Matrix* context, const puzzle_batch* batch, int index) {
+    int dim = batch->dim;
+    size_t num_cells = (size_t)dim * dim;
+    const int* puzzle = batch->puzzles + num_cells * index;
+    int* solution = batch->solutions + num_cells * index;
+    
+    if (!context || !copy_matrix(context, batch->template)) {
+        return solve_puzzle_budget(puzzle, dim, solution, 0);
+    }
+    
+    memcpy(solution, puzzle, num_cells * sizeof(int));
+    if (!cover_givens(context, puzzle, dim)) return SEARCH_UNSAT;
+    
+    return search_restarts(context, puzzle, dim, 0, solution);
+}
+
+/**
+ * @brief Counts the solutions of one puzzle of a batch using a worker's own matrix
+ * @param context Worker's matrix, reset from the template for this puzzle (NULL to build one)
+ * @param batch Batch holding the puzzle and the limit
+ * @param index Index of the puzzle in the batch
+ * @return Number of solutions found, at most the batch limit
+ */
+static long long count_with_context(Matrix* context, const puzzle_batch* batch, int index) {
+    int dim = batch->dim;
+    const int* puzzle = batch->puzzles + (size_t)dim * dim * index;
+    
+    if (!context || !copy_matrix(context, batch->template)) {
+        return count_solutions(puzzle, dim, batch->limit);
+    }
+    
+    if (!cover_givens(context, puzzle, dim)) return 0;
+    return alg_x_count(context, batch->limit);
 }
 
 /**
@@ -110,7 +1135,13 @@ bool solve_puzzle(const int* puzzle, int dim, int* solution) {
 bool validate_solution(const int* board, int dim) {
     if (!board) return false;
     
-    int box_size = (int)sqrt(dim);
+    // Specialized dimensions fold their unit arithmetic into constants; other
+    // boards whose value masks fit a lane are checked by the vector kernel
+    const constraint_kernel* kernel = constraint_kernel_for(dim);
+    if (kernel) return kernel->validate(board);
+    if (dim <= KERNEL_MAX_DIM) return kernel_validate_board(board, dim);
+    
+    int box_size = box_size_of(dim);
     int* checker = (int*)calloc(dim + 1, sizeof(int));
     if (!checker) return false;
     
@@ -164,125 +1195,95 @@ bool validate_solution(const int* board, int dim) {
 }
 
 /**
- * @brief Checks if a Sudoku puzzle has a unique solution
+ * @brief Counts the solutions of a Sudoku puzzle, stopping once limit have been found
  * @param puzzle Array representing the initial Sudoku puzzle (0 for empty cells)
  * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
- * @return true if the puzzle has a unique solution, false otherwise
+ * @param limit Stop after this many solutions, 0 or less for no limit
+ * @return Number of solutions found, at most limit (0 for contradictory or out of range givens)
  */
-bool has_unique_solution(const int* puzzle, int dim) {
-    Matrix* matrix = puzzle_to_matrix(puzzle, dim);
-    if (!matrix) return false;
+long long count_solutions(const int* puzzle, int dim, long long limit) {
+    if (!puzzle) return 0;
     
-    // Find the first solution
-    bool found_first = alg_x_search(matrix);
-    if (!found_first) {
-        delete_matrix(matrix);
-        return false; // No solution
-    }
+    Matrix* matrix = puzzle_to_matrix(puzzle, dim);
+    if (!matrix) return 0;
     
-    // Save the first solution
-    int solution_size = 0;
-    for (solution_node* itr = matrix->solution->head; itr != NULL; itr = itr->next) {
-        solution_size++;
-    }
+    long long count = alg_x_count(matrix, limit);
     
-    int* first_solution = (int*)malloc(solution_size * sizeof(int));
-    if (!first_solution) {
-        delete_matrix(matrix);
-        return false;
-    }
+    delete_matrix(matrix);
+    return count;
+}
+
+/**
+ * @brief Decoding state shared by enumerate_solutions and its matrix callback
+ */
+typedef struct {
+    int* board;                 // Givens plus the cells of the current solution
+    int dim;
+    board_callback callback;
+    void* data;
+} board_decoder;
+
+/**
+ * @brief Write an exact cover into the decoder's board and pass the board on
+ * @param rows One data node of each chosen row
+ * @param num_rows Number of chosen rows
+ * @param data Pointer to the board_decoder
+ * @return The caller's callback result
+ */
+static bool decode_board(Node* const* rows, int num_rows, void* data) {
+    board_decoder* decoder = (board_decoder*)data;
+    int dim = decoder->dim;
     
-    int i = 0;
-    for (solution_node* itr = matrix->solution->head; itr != NULL; itr = itr->next) {
-        first_solution[i++] = ((Node*)itr->data)->row;
+    // Every empty cell is chosen exactly once per solution, so the board
+    // never needs resetting between solutions
+    const constraint_kernel* kernel = constraint_kernel_for(dim);
+    if (kernel) {
+        kernel->decode(rows, num_rows, decoder->board);
+    } else {
+        decode_placements(rows, num_rows, dim, decoder->board);
     }
     
-    // Clear the solution and try to find a second one
-    clear_solution(matrix->solution);
-    
-    // Modify the search to exclude the first solution
-    // We'll create a custom alg_x_search function that avoids the first solution
-    
-    // Create a function pointer to the original cover_column function
-    void (*original_cover)(Matrix*, int) = matrix->cover_column;
+    return decoder->callback(decoder->board, dim, decoder->data);
+}
+
+/**
+ * @brief Passes every solution of a Sudoku puzzle to a callback, stopping once limit have been found
+ * @param puzzle Array representing the initial Sudoku puzzle (0 for empty cells)
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param limit Stop after this many solutions, 0 or less for no limit
+ * @param callback Function called with each solved board
+ * @param data Caller data passed through to the callback
+ * @return Number of solutions passed to the callback
+ */
+long long enumerate_solutions(const int* puzzle, int dim, long long limit, board_callback callback, void* data) {
+    if (!puzzle || !callback) return 0;
     
-    // Set up variables to track search state
-    bool found_second = false;
-    int depth = 0;
-    int max_depth = solution_size;
+    Matrix* matrix = puzzle_to_matrix(puzzle, dim);
+    if (!matrix) return 0;
     
-    // Custom search function that tries to find a different solution
-    bool try_different_solution(Matrix* m) {
-        if (depth >= max_depth) {
-            found_second = true;
-            return true;
-        }
-        
-        // Choose a column and cover it
-        int col = choose_column(m);
-        if (col < 0) return true; // No more columns to cover
-        
-        original_cover(m, col);
-        
-        // Try each row in this column
-        Node* row_node = m->col_headers[col].down;
-        while (row_node != &m->col_headers[col]) {
-            // Skip this row if it's part of the first solution
-            bool in_first_solution = false;
-            for (int j = 0; j < solution_size; j++) {
-                if (row_node->row == first_solution[j]) {
-                    in_first_solution = true;
-                    break;
-                }
-            }
-            
-            if (!in_first_solution) {
-                // Cover all other columns in this row
-                Node* node = row_node;
-                do {
-                    cover_column(m, node->col);
-                    node = node->right;
-                } while (node != row_node);
-                
-                // Add this row to the solution
-                push_solution(m->solution, row_node);
-                depth++;
-                
-                // Recursive search
-                if (try_different_solution(m)) {
-                    found_second = true;
-                    return true;
-                }
-                
-                // Backtrack
-                pop_solution(m->solution);
-                depth--;
-                
-                // Uncover columns
-                node = row_node->left;
-                do {
-                    uncover_column(m, node->col);
-                    node = node->left;
-                } while (node != row_node->left);
-            }
-            
-            row_node = row_node->down;
-        }
-        
-        // Uncover this column and backtrack
-        uncover_column(m, col);
-        return false;
+    board_decoder decoder = { (int*)malloc(dim * dim * sizeof(int)), dim, callback, data };
+    if (!decoder.board) {
+        delete_matrix(matrix);
+        return 0;
     }
+    memcpy(decoder.board, puzzle, dim * dim * sizeof(int));
     
-    // Try to find a second solution
-    try_different_solution(matrix);
+    long long count = alg_x_enumerate(matrix, limit, decode_board, &decoder);
     
-    // Clean up
-    free(first_solution);
+    free(decoder.board);
     delete_matrix(matrix);
-    
-    // If we found a second solution, the puzzle doesn't have a unique solution
-    return !found_second;
+    return count;
+}
+
+/**
+ * @brief Checks if a Sudoku puzzle has a unique solution
+ * @param puzzle Array representing the initial Sudoku puzzle (0 for empty cells)
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @return true if the puzzle has a unique solution, false otherwise
+ */
+bool has_unique_solution(const int* puzzle, int dim) {
+    // Any second solution settles it, so the search stops there
+    return count_solutions(puzzle, dim, 2) == 1;
 }
 
 /**
@@ -319,6 +1320,28 @@ int get_puzzle_difficulty(const int* puzzle, int dim) {
  * @return true if a puzzle is successfully generated, false otherwise
  */
 bool generate_puzzle(int* puzzle, int dim, int difficulty) {
+    return generate_puzzle_parallel(puzzle, dim, difficulty, 1);
+}
+
+/**
+ * @brief Generates a random Sudoku puzzle, testing cell removals on several threads
+ *
+ * Removals are tried in batches of num_threads, each tested for uniqueness
+ * against the current puzzle with count_many. Every removal of a batch that
+ * keeps the solution unique is taken if the puzzle with all of them removed
+ * is still unique, which is checked once with count_solutions_parallel;
+ * otherwise only the first is taken and the others are retested against
+ * the new puzzle. A rejected removal stays rejected, since removing more
+ * cells can only add solutions. With one thread this is the plain
+ * remove-and-check loop.
+ *
+ * @param puzzle Array to store the generated puzzle (must be pre-allocated)
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param difficulty Difficulty level (1=Easy, 2=Medium, 3=Hard, 4=Expert, 5=Evil)
+ * @param num_threads Number of threads to test removals with, the calling thread included
+ * @return true if a puzzle is successfully generated, false otherwise
+ */
+bool generate_puzzle_parallel(int* puzzle, int dim, int difficulty, int num_threads) {
     if (!puzzle) return false;
     
     // Initialize all cells to empty
@@ -415,38 +1438,87 @@ bool generate_puzzle(int* puzzle, int dim, int difficulty) {
         indices[j] = temp;
     }
     
-    // Remove cells one by one and check if puzzle still has a unique solution
-    int* temp_puzzle = (int*)malloc(dim * dim * sizeof(int));
-    if (!temp_puzzle) {
+    // Remove cells in shuffled order, keeping only removals that leave a unique solution
+    int num_cells = dim * dim;
+    if (num_threads < 1) num_threads = 1;
+    
+    int* trials = (int*)malloc(sizeof(int) * num_cells * num_threads);
+    long long* counts = (long long*)malloc(sizeof(long long) * num_threads);
+    int* batch = (int*)malloc(sizeof(int) * num_threads);          // Position in indices of each trial
+    bool* settled = (bool*)calloc(num_cells, sizeof(bool));         // Removal taken or rejected for good
+    if (!trials || !counts || !batch || !settled) {
         free(full_puzzle);
         free(indices);
+        free(trials);
+        free(counts);
+        free(batch);
+        free(settled);
         return false;
     }
     
     int removed = 0;
-    for (int i = 0; i < dim * dim && removed < cells_to_remove; i++) {
-        int idx = indices[i];
-        int original_value = puzzle[idx];
+    int head = 0;       // No position before head is still open
+    while (removed < cells_to_remove && head < num_cells) {
+        // Each trial is the current puzzle with one more open cell removed
+        int n = 0;
+        for (int i = head; i < num_cells && n < num_threads; i++) {
+            if (settled[i]) continue;
+            
+            int* trial = trials + (size_t)n * num_cells;
+            memcpy(trial, puzzle, num_cells * sizeof(int));
+            trial[indices[i]] = 0;
+            batch[n++] = i;
+        }
         
-        // Try removing this cell
-        puzzle[idx] = 0;
+        count_many(trials, n, dim, 2, counts, num_threads);
         
-        // Copy to temp puzzle for testing
-        memcpy(temp_puzzle, puzzle, dim * dim * sizeof(int));
+        // Take every removal that passed on its own, as long as they still
+        // leave a unique solution together
+        int* combined = trials;
+        int passed = 0, first = -1;
+        memcpy(combined, puzzle, num_cells * sizeof(int));
+        for (int k = 0; k < n; k++) {
+            if (counts[k] != 1) {
+                settled[batch[k]] = true;
+            } else if (removed + passed < cells_to_remove) {
+                combined[indices[batch[k]]] = 0;
+                if (first < 0) first = k;
+                passed++;
+            }
+        }
         
-        // Check if the puzzle still has a unique solution
-        if (!has_unique_solution(temp_puzzle, dim)) {
-            // If not, put the value back
-            puzzle[idx] = original_value;
-        } else {
-            removed++;
+        bool together = passed > 1 && count_solutions_parallel(combined, dim, 2, num_threads) == 1;
+        for (int k = 0; k < n && passed > 0; k++) {
+            if (counts[k] != 1 || combined[indices[batch[k]]] != 0) continue;
+            
+            // If the joint check failed only the first is taken; the others are retested against the new puzzle
+            if (together || k == first) {
+                puzzle[indices[batch[k]]] = 0;
+                settled[batch[k]] = true;
+                removed++;
+            }
         }
+        
+        while (head < num_cells && settled[head]) head++;
     }
     
     // Clean up
     free(full_puzzle);
     free(indices);
-    free(temp_puzzle);
+    free(trials);
+    free(counts);
+    free(batch);
+    free(settled);
     
     return true;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Monotonic wall clock time
+ * @return Time in microseconds
+ */
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec * 1e-3;
+}
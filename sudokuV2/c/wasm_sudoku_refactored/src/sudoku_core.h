@@ -7,20 +7,78 @@
  */
 
 #include <stdbool.h>
+#include "dlinks_index.h"
 #include "dlinks_matrix.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * @brief Matrix representation used by the exact cover search
+ */
+typedef enum {
+    SOLVER_ENGINE_POINTER = 0,  // Linked Node structs (dlinks_matrix.h)
+    SOLVER_ENGINE_INDEX = 1     // Struct of int32_t index arrays (dlinks_index.h)
+} solver_engine;
+
+/**
+ * @brief Work done by solve_puzzle_stats for one puzzle
+ *
+ * Unlike the empty cell count used by get_puzzle_difficulty, the search
+ * counters measure how hard the puzzle actually was for the solver.
+ */
+typedef struct {
+    search_stats search;        // Counters of the exact cover search (see dlinks_matrix.h)
+    double build_us;            // Microseconds spent building the matrix and covering the givens
+    double search_us;           // Microseconds spent searching and decoding the solution
+} solve_stats;
+
+/**
+ * @brief Receives each solved board found by enumerate_solutions
+ *
+ * board is reused for every solution and is only valid during the call.
+ *
+ * @param board Solved board, givens included
+ * @param dim Dimension of the puzzle
+ * @param data Caller data given to enumerate_solutions
+ * @return true to keep enumerating, false to stop
+ */
+typedef bool (*board_callback)(const int* board, int dim, void* data);
+
 /**
  * @brief Converts a Sudoku puzzle into a constraint matrix for Algorithm X
+ *
+ * The full candidate matrix of the dimension is cloned from a cached
+ * template and the rows of the givens are then covered, so only the empty
+ * cells are left for the search. Grids larger than 25x25 are not cached:
+ * their matrix is built with only the candidates the givens leave open.
+ * Every node holds the placement (cell * dim + value - 1) of its row.
+ *
  * @param sudoku_list Array representing the Sudoku puzzle (0 for empty cells)
  * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
- * @return Pointer to the constraint matrix
+ * @return Pointer to the constraint matrix, or NULL if the givens contradict each other or a cell is out of range
  */
 Matrix* puzzle_to_matrix(const int* sudoku_list, int dim);
 
+/**
+ * @brief Frees the template matrices cached by puzzle_to_matrix
+ */
+void free_matrix_templates(void);
+
+/**
+ * @brief Converts a Sudoku puzzle into an index based constraint matrix for Algorithm X
+ *
+ * Only the givens and the candidates they leave open get nodes, and the
+ * rows of the givens are covered. With 32-bit node indices this is the
+ * compact representation for large grids such as 36x36 and 49x49.
+ *
+ * @param sudoku_list Array representing the Sudoku puzzle (0 for empty cells)
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @return Pointer to the constraint matrix, or NULL if the givens contradict each other
+ */
+IndexMatrix* puzzle_to_index_matrix(const int* sudoku_list, int dim);
+
 /**
  * @brief Solves a Sudoku puzzle
  * @param puzzle Array representing the initial Sudoku puzzle (0 for empty cells)
@@ -30,6 +88,86 @@ Matrix* puzzle_to_matrix(const int* sudoku_list, int dim);
  */
 bool solve_puzzle(const int* puzzle, int dim, int* solution);
 
+/**
+ * @brief Solves a Sudoku puzzle with the chosen matrix representation
+ *
+ * Both engines search with the restarts of solve_puzzle_budget; solve_puzzle
+ * picks the engine by dimension instead.
+ *
+ * @param puzzle Array representing the initial Sudoku puzzle (0 for empty cells)
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param solution Array to store the solution (must be pre-allocated)
+ * @param engine Matrix representation to search with
+ * @return true if a solution is found, false otherwise
+ */
+bool solve_puzzle_with_engine(const int* puzzle, int dim, int* solution, solver_engine engine);
+
+/**
+ * @brief Solves a Sudoku puzzle, giving up after a fixed amount of search
+ *
+ * Bounds the work spent on pathological or unsolvable inputs. The budget
+ * counts candidate placements tried by the search, not the givens. A search
+ * that runs long is restarted with its rows and columns in another order,
+ * which cuts the heavy tail of search times on large grids. Grids up to
+ * 25x25 are searched on the pointer engine, larger ones on the index engine
+ * (see solver_engine), whose smaller nodes suit 36x36 and 49x49 matrices.
+ *
+ * @param puzzle Array representing the initial Sudoku puzzle (0 for empty cells)
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param solution Array to store the solution (must be pre-allocated)
+ * @param budget Maximum number of candidate placements to try, 0 or less for no limit
+ * @return SEARCH_SOLVED, SEARCH_UNSAT (also for contradictory or out of range givens) or SEARCH_BUDGET_EXHAUSTED
+ */
+search_status solve_puzzle_budget(const int* puzzle, int dim, int* solution, long long budget);
+
+/**
+ * @brief Solves a Sudoku puzzle and reports the work the search took
+ *
+ * Same as solve_puzzle_budget, with the search counters and the time spent
+ * in matrix build versus search written to stats.
+ *
+ * @param puzzle Array representing the initial Sudoku puzzle (0 for empty cells)
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param solution Array to store the solution (must be pre-allocated)
+ * @param budget Maximum number of candidate placements to try, 0 or less for no limit
+ * @param stats Receives the search counters and timings, or NULL
+ * @return SEARCH_SOLVED, SEARCH_UNSAT (also for contradictory or out of range givens) or SEARCH_BUDGET_EXHAUSTED
+ */
+search_status solve_puzzle_stats(const int* puzzle, int dim, int* solution, long long budget, solve_stats* stats);
+
+/**
+ * @brief Solves a batch of Sudoku puzzles of one dimension across several threads
+ *
+ * Workers take puzzles in small chunks from a shared counter. Each keeps one
+ * matrix for the whole batch and resets it from the cached template before
+ * every puzzle instead of allocating a new one.
+ *
+ * @param puzzles n puzzles of dim * dim cells each, back to back (0 for empty cells)
+ * @param n Number of puzzles
+ * @param dim Dimension of the puzzles (e.g., 9 for 9x9 puzzles)
+ * @param solutions Array of n * dim * dim cells receiving the solutions (must be pre-allocated)
+ * @param status Array of n entries receiving SEARCH_SOLVED or SEARCH_UNSAT per puzzle, or NULL
+ * @param num_threads Number of threads to solve with, the calling thread included
+ * @return Number of puzzles solved
+ */
+int solve_many(const int* puzzles, int n, int dim, int* solutions, search_status* status, int num_threads);
+
+/**
+ * @brief Counts the solutions of a batch of Sudoku puzzles of one dimension across several threads
+ *
+ * Shares the worker pool of solve_many: each puzzle is counted on one
+ * thread, so this suits many small searches such as uniqueness checks.
+ *
+ * @param puzzles n puzzles of dim * dim cells each, back to back (0 for empty cells)
+ * @param n Number of puzzles
+ * @param dim Dimension of the puzzles (e.g., 9 for 9x9 puzzles)
+ * @param limit Stop counting a puzzle after this many solutions, 0 or less for no limit
+ * @param counts Array of n entries receiving the solution count of each puzzle
+ * @param num_threads Number of threads to count with, the calling thread included
+ * @return Number of puzzles with at least one solution
+ */
+int count_many(const int* puzzles, int n, int dim, long long limit, long long* counts, int num_threads);
+
 /**
  * @brief Validates a Sudoku puzzle solution
  * @param board Array representing the Sudoku board
@@ -38,6 +176,47 @@ bool solve_puzzle(const int* puzzle, int dim, int* solution);
  */
 bool validate_solution(const int* board, int dim);
 
+/**
+ * @brief Counts the solutions of a Sudoku puzzle, stopping once limit have been found
+ *
+ * One matrix is built and searched in place, so the cost of a small limit is
+ * only the search up to the limit-th solution.
+ *
+ * @param puzzle Array representing the initial Sudoku puzzle (0 for empty cells)
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param limit Stop after this many solutions, 0 or less for no limit
+ * @return Number of solutions found, at most limit (0 for contradictory or out of range givens)
+ */
+long long count_solutions(const int* puzzle, int dim, long long limit);
+
+/**
+ * @brief Counts the solutions of one Sudoku puzzle, splitting its search tree across several threads
+ *
+ * Suits one large search, such as counting a sparse puzzle; see
+ * parallel_count in dlinks_parallel.h.
+ *
+ * @param puzzle Array representing the initial Sudoku puzzle (0 for empty cells)
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param limit Stop after this many solutions, 0 or less for no limit
+ * @param num_threads Number of threads to count with, the calling thread included
+ * @return Number of solutions found, at most limit (0 for contradictory or out of range givens)
+ */
+long long count_solutions_parallel(const int* puzzle, int dim, long long limit, int num_threads);
+
+/**
+ * @brief Passes every solution of a Sudoku puzzle to a callback, stopping once limit have been found
+ *
+ * Solutions are decoded into one board allocated per call, not per solution.
+ *
+ * @param puzzle Array representing the initial Sudoku puzzle (0 for empty cells)
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param limit Stop after this many solutions, 0 or less for no limit
+ * @param callback Function called with each solved board
+ * @param data Caller data passed through to the callback
+ * @return Number of solutions passed to the callback
+ */
+long long enumerate_solutions(const int* puzzle, int dim, long long limit, board_callback callback, void* data);
+
 /**
  * @brief Checks if a Sudoku puzzle has a unique solution
  * @param puzzle Array representing the initial Sudoku puzzle (0 for empty cells)
@@ -63,6 +242,20 @@ int get_puzzle_difficulty(const int* puzzle, int dim);
  */
 bool generate_puzzle(int* puzzle, int dim, int difficulty);
 
+/**
+ * @brief Generates a random Sudoku puzzle, testing cell removals on several threads
+ *
+ * Candidate removals are checked for uniqueness in batches of num_threads
+ * with count_many. With one thread this is generate_puzzle.
+ *
+ * @param puzzle Array to store the generated puzzle (must be pre-allocated)
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param difficulty Difficulty level (1=Easy, 2=Medium, 3=Hard, 4=Expert, 5=Evil)
+ * @param num_threads Number of threads to test removals with, the calling thread included
+ * @return true if a puzzle is successfully generated, false otherwise
+ */
+bool generate_puzzle_parallel(int* puzzle, int dim, int difficulty, int num_threads);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,198 @@
+#include <string.h>
+#include "sudoku_kernels.h"
+
+// Vector width: SIMD128 in the browser, SSE2 on x86-64 hosts, scalar otherwise
+#if defined(__wasm_simd128__) || defined(__SSE2__)
+#define KERNEL_LANES 4
+typedef uint32_t lane_vec __attribute__((vector_size(16)));
+#else
+#define KERNEL_LANES 1
+typedef uint32_t lane_vec;
+#endif
+
+// Lanes per layout row: KERNEL_MAX_DIM rounded up to whole vectors
+#define KERNEL_STRIDE ((KERNEL_MAX_DIM + KERNEL_LANES - 1) / KERNEL_LANES * KERNEL_LANES)
+
+/**
+ * @brief Cell masks of a board laid out once per unit kind
+ *
+ * by_col[r][c] is the mask of cell (r, c), so lane c ORed down the rows is
+ * column c. by_row holds the transpose and by_box[k][b] the k-th cell of box
+ * b, giving rows and boxes their own lanes the same way.
+ */
+typedef struct {
+    uint32_t by_col[KERNEL_MAX_DIM][KERNEL_STRIDE];
+    uint32_t by_row[KERNEL_MAX_DIM][KERNEL_STRIDE];
+    uint32_t by_box[KERNEL_MAX_DIM][KERNEL_STRIDE];
+} unit_layouts;
+
+// Forward declarations of helper functions
+static int box_size_of(int dim);
+static bool load_units(const int* board, int dim, bool allow_empty, unit_layouts* units);
+static void or_lanes(const uint32_t (*layout)[KERNEL_STRIDE], int dim, uint32_t* masks);
+static inline lane_vec load_lanes(const uint32_t* p);
+static inline void store_lanes(uint32_t* p, lane_vec v);
+
+/**
+ * @brief Check whether the kernels were built with vector instructions
+ * @return true for the SIMD build, false for the scalar one
+ */
+bool kernels_use_simd(void) {
+    return KERNEL_LANES > 1;
+}
+
+/**
+ * @brief Check that a board is completely and correctly filled
+ * @param board Array of dim * dim cells
+ * @param dim Dimension of the board, at most KERNEL_MAX_DIM
+ * @return true if every row, column and box holds each value exactly once
+ */
+bool kernel_validate_board(const int* board, int dim) {
+    unit_layouts units;
+    if (!load_units(board, dim, false, &units)) return false;
+
+    uint32_t cols[KERNEL_STRIDE], rows[KERNEL_STRIDE], boxes[KERNEL_STRIDE];
+    or_lanes(units.by_col, dim, cols);
+    or_lanes(units.by_row, dim, rows);
+    or_lanes(units.by_box, dim, boxes);
+
+    // dim cells holding one bit each cover all dim values only if no value repeats
+    uint32_t full = ((1u << dim) - 1) << 1;
+    for (int lane = 0; lane < dim; lane++) {
+        if ((cols[lane] & rows[lane] & boxes[lane]) != full) return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Compute the values still open to every empty cell of a puzzle
+ * @param puzzle Array of dim * dim cells (0 for empty cells)
+ * @param dim Dimension of the puzzle, at most KERNEL_MAX_DIM
+ * @param candidates Array of dim * dim masks to fill
+ * @return true on success, false if dim is too large or a cell is out of range
+ */
+bool kernel_candidates(const int* puzzle, int dim, uint32_t* candidates) {
+    unit_layouts units;
+    if (!load_units(puzzle, dim, true, &units)) return false;
+
+    uint32_t cols[KERNEL_STRIDE], rows[KERNEL_STRIDE], boxes[KERNEL_STRIDE];
+    or_lanes(units.by_col, dim, cols);
+    or_lanes(units.by_row, dim, rows);
+    or_lanes(units.by_box, dim, boxes);
+
+    int box_size = box_size_of(dim);
+    uint32_t full = ((1u << dim) - 1) << 1;
+    uint32_t band[KERNEL_STRIDE] = { 0 };   // Box mask under each column of the current band
+    uint32_t open[KERNEL_STRIDE];
+
+    for (int r = 0; r < dim; r++) {
+        if (r % box_size == 0) {
+            for (int c = 0; c < dim; c++) {
+                band[c] = boxes[(r / box_size) * box_size + c / box_size];
+            }
+        }
+
+        // Scalars in vector expressions are broadcast to every lane
+        for (int lane = 0; lane < dim; lane += KERNEL_LANES) {
+            lane_vec used = load_lanes(cols + lane) | load_lanes(band + lane) | rows[r];
+            store_lanes(open + lane, ~used & full);
+        }
+
+        for (int c = 0; c < dim; c++) {
+            candidates[r * dim + c] = puzzle[r * dim + c] ? 0 : open[c];
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Side of the boxes of a dimension
+ * @param dim Dimension of the board
+ * @return Box size, or 0 if dim is not a perfect square
+ */
+static int box_size_of(int dim) {
+    int box_size = 1;
+    while (box_size * box_size < dim) box_size++;
+    return box_size * box_size == dim ? box_size : 0;
+}
+
+/**
+ * @brief Turn every cell of a board into its mask, written into all three layouts
+ * @param board Array of dim * dim cells
+ * @param dim Dimension of the board
+ * @param allow_empty Whether cells may be 0 (their mask is 0)
+ * @param units Layouts to fill; lanes past dim up to the next whole vector are set to 0
+ * @return true on success, false if dim is unsupported or a cell is out of range
+ */
+static bool load_units(const int* board, int dim, bool allow_empty, unit_layouts* units) {
+    int box_size = box_size_of(dim);
+    if (!board || dim < 1 || dim > KERNEL_MAX_DIM || box_size == 0) return false;
+
+    // Only the lanes that pad the last vector of each row need clearing
+    int padded = (dim + KERNEL_LANES - 1) / KERNEL_LANES * KERNEL_LANES;
+    for (int r = 0; r < dim; r++) {
+        for (int lane = dim; lane < padded; lane++) {
+            units->by_col[r][lane] = units->by_row[r][lane] = units->by_box[r][lane] = 0;
+        }
+    }
+
+    // Walking each row box by box keeps divisions out of the cell loop
+    for (int r = 0; r < dim; r++) {
+        int band = r / box_size * box_size;
+        int cell_row = r % box_size * box_size;
+
+        for (int c = 0, stack = 0; stack < box_size; stack++) {
+            for (int k = 0; k < box_size; k++, c++) {
+                int value = board[r * dim + c];
+                if (value < (allow_empty ? 0 : 1) || value > dim) return false;
+
+                uint32_t mask = value ? 1u << value : 0;
+                units->by_col[r][c] = mask;
+                units->by_row[c][r] = mask;
+                units->by_box[cell_row + k][band + stack] = mask;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief OR the first dim rows of a layout together, lane by lane
+ * @param layout Layout whose lanes are units
+ * @param dim Number of rows to combine
+ * @param masks Receives the mask of every unit, dim lanes rounded up to whole vectors
+ */
+static void or_lanes(const uint32_t (*layout)[KERNEL_STRIDE], int dim, uint32_t* masks) {
+    for (int lane = 0; lane < dim; lane += KERNEL_LANES) {
+        lane_vec acc = load_lanes(layout[0] + lane);
+
+        for (int r = 1; r < dim; r++) {
+            acc |= load_lanes(layout[r] + lane);
+        }
+
+        store_lanes(masks + lane, acc);
+    }
+}
+
+/**
+ * @brief Load KERNEL_LANES consecutive masks
+ * @param p Pointer to the first mask
+ * @return Vector of the masks
+ */
+static inline lane_vec load_lanes(const uint32_t* p) {
+    lane_vec v;
+    memcpy(&v, p, sizeof(lane_vec));
+    return v;
+}
+
+/**
+ * @brief Store KERNEL_LANES consecutive masks
+ * @param p Pointer to the first mask
+ * @param v Vector of the masks
+ */
+static inline void store_lanes(uint32_t* p, lane_vec v) {
+    memcpy(p, &v, sizeof(lane_vec));
+}
@@ -0,0 +1,56 @@
+#ifndef SUDOKU_KERNELS_H
+#define SUDOKU_KERNELS_H
+
+/**
+ * @file sudoku_kernels.h
+ * @brief Data-parallel board kernels: validation and candidate masks
+ *
+ * A board is checked one bit mask per cell, bit v standing for value v. The
+ * masks are laid out three times, once per unit kind, so that every unit
+ * (row, column or box) becomes one lane and its mask is the OR down dim
+ * rows of lanes. Built with SIMD128 (-msimd128) or SSE2 those ORs run four
+ * lanes per instruction; elsewhere the same code runs one lane at a time.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Largest dimension whose value masks fit one 32 bit lane
+#define KERNEL_MAX_DIM 25
+
+/**
+ * @brief Check whether the kernels were built with vector instructions
+ * @return true for the SIMD build, false for the scalar one
+ */
+bool kernels_use_simd(void);
+
+/**
+ * @brief Check that a board is completely and correctly filled
+ * @param board Array of dim * dim cells
+ * @param dim Dimension of the board, at most KERNEL_MAX_DIM
+ * @return true if every row, column and box holds each value exactly once
+ */
+bool kernel_validate_board(const int* board, int dim);
+
+/**
+ * @brief Compute the values still open to every empty cell of a puzzle
+ *
+ * Bit v of candidates[i] is set if value v appears in neither the row, the
+ * column nor the box of cell i. Filled cells get 0.
+ *
+ * @param puzzle Array of dim * dim cells (0 for empty cells)
+ * @param dim Dimension of the puzzle, at most KERNEL_MAX_DIM
+ * @param candidates Array of dim * dim masks to fill
+ * @return true on success, false if dim is too large or a cell is out of range
+ */
+bool kernel_candidates(const int* puzzle, int dim, uint32_t* candidates);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SUDOKU_KERNELS_H */
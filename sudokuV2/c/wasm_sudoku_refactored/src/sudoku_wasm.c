@@ -1,9 +1,18 @@
 #include <emscripten.h>
+#ifdef __EMSCRIPTEN_PTHREADS__
+#include <emscripten/threading.h>
+#endif
 #include <stdlib.h>
 #include <string.h>
 #include "sudoku_core.h"
+#include "sudoku_kernels.h"
 #include "sudoku_wasm.h"
 
+// Forward declarations of helper functions
+static int resolve_threads(int numThreads);
+static void unpack_boards(const uint8_t* boards, size_t num_cells, int* cells);
+static void pack_boards(const int* cells, size_t num_cells, uint8_t* boards);
+
 /**
  * @brief Solve a Sudoku puzzle and return the solution
  * 
@@ -20,6 +29,38 @@ int solve_sudoku(const int* puzzlePtr, int dim, int* solutionPtr) {
     return solve_puzzle(puzzlePtr, dim, solutionPtr) ? 1 : 0;
 }
 
+/**
+ * @brief Solve a Sudoku puzzle and report the work the search took
+ * 
+ * This function is exported to JavaScript and solves a Sudoku puzzle like
+ * solve_sudoku, writing SUDOKU_STATS_LENGTH values to statsPtr in this
+ * order: search nodes, cover calls, uncover calls, links touched,
+ * backtracks, maximum depth, build time and search time (microseconds).
+ * 
+ * @param puzzlePtr Pointer to the Sudoku puzzle array in the WASM memory
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param solutionPtr Pointer to the solution array in the WASM memory
+ * @param statsPtr Pointer to SUDOKU_STATS_LENGTH doubles in the WASM memory
+ * @return 1 if a solution is found, 0 otherwise
+ */
+EMSCRIPTEN_KEEPALIVE
+int solve_sudoku_stats(const int* puzzlePtr, int dim, int* solutionPtr, double* statsPtr) {
+    solve_stats stats;
+    bool solved = solve_puzzle_stats(puzzlePtr, dim, solutionPtr, 0, &stats) == SEARCH_SOLVED;
+    
+    // Doubles hold every count exactly up to 2^53 and read directly as JS numbers
+    statsPtr[0] = (double)stats.search.nodes;
+    statsPtr[1] = (double)stats.search.covers;
+    statsPtr[2] = (double)stats.search.uncovers;
+    statsPtr[3] = (double)stats.search.links;
+    statsPtr[4] = (double)stats.search.backtracks;
+    statsPtr[5] = (double)stats.search.max_depth;
+    statsPtr[6] = stats.build_us;
+    statsPtr[7] = stats.search_us;
+    
+    return solved ? 1 : 0;
+}
+
 /**
  * @brief Allocate memory for a Sudoku puzzle or solution
  * 
@@ -47,6 +88,62 @@ void free_sudoku_array(int* ptr) {
     free(ptr);
 }
 
+/**
+ * @brief Allocate memory for the statistics of solve_sudoku_stats
+ * 
+ * This function is exported to JavaScript and allocates SUDOKU_STATS_LENGTH
+ * doubles in the WASM memory.
+ * 
+ * @return Pointer to the allocated memory
+ */
+EMSCRIPTEN_KEEPALIVE
+double* allocate_sudoku_stats(void) {
+    return (double*)malloc(SUDOKU_STATS_LENGTH * sizeof(double));
+}
+
+/**
+ * @brief Free memory allocated for solve_sudoku_stats statistics
+ * 
+ * This function is exported to JavaScript and frees memory allocated by
+ * allocate_sudoku_stats.
+ * 
+ * @param ptr Pointer to the memory to free
+ */
+EMSCRIPTEN_KEEPALIVE
+void free_sudoku_stats(double* ptr) {
+    free(ptr);
+}
+
+/**
+ * @brief Allocate memory for byte-packed Sudoku boards
+ * 
+ * This function is exported to JavaScript and allocates n boards of
+ * dim * dim bytes each, back to back, for the *_sudoku_boards functions.
+ * JavaScript reads and writes them through a Uint8Array view of the heap.
+ * 
+ * @param dim Dimension of the boards (e.g., 9 for 9x9 boards)
+ * @param n Number of boards
+ * @return Pointer to the allocated memory, NULL if out of memory
+ */
+EMSCRIPTEN_KEEPALIVE
+uint8_t* allocate_sudoku_boards(int dim, int n) {
+    if (dim < 1 || n < 1) return NULL;
+    return (uint8_t*)malloc((size_t)dim * dim * n);
+}
+
+/**
+ * @brief Free memory allocated for byte-packed Sudoku boards
+ * 
+ * This function is exported to JavaScript and frees memory allocated by
+ * allocate_sudoku_boards.
+ * 
+ * @param ptr Pointer to the memory to free
+ */
+EMSCRIPTEN_KEEPALIVE
+void free_sudoku_boards(uint8_t* ptr) {
+    free(ptr);
+}
+
 /**
  * @brief Set a value in a Sudoku puzzle or solution
  * 
@@ -106,6 +203,54 @@ int has_unique_sudoku_solution(const int* puzzlePtr, int dim) {
     return has_unique_solution(puzzlePtr, dim) ? 1 : 0;
 }
 
+/**
+ * @brief Count the solutions of a Sudoku puzzle up to a limit
+ * 
+ * This function is exported to JavaScript and counts the solutions of a
+ * Sudoku puzzle, stopping as soon as limit solutions have been found.
+ * 
+ * @param puzzlePtr Pointer to the puzzle array in the WASM memory
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param limit Maximum number of solutions to count (must be positive)
+ * @return Number of solutions found, at most limit
+ */
+EMSCRIPTEN_KEEPALIVE
+int count_sudoku_solutions(const int* puzzlePtr, int dim, int limit) {
+    // A non-positive limit would mean no limit, which can overflow the int result
+    if (limit < 1) return 0;
+    return (int)count_solutions(puzzlePtr, dim, limit);
+}
+
+/**
+ * @brief Compute the candidate values of every empty cell of a puzzle
+ * 
+ * This function is exported to JavaScript and writes one bit mask per cell:
+ * bit v is set if value v can still go in that cell. Filled cells get 0.
+ * 
+ * @param puzzlePtr Pointer to the puzzle array in the WASM memory
+ * @param dim Dimension of the puzzle (at most 25)
+ * @param candidatesPtr Pointer to an array of dim * dim ints in the WASM memory
+ * @return 1 on success, 0 if the puzzle is malformed or too large
+ */
+EMSCRIPTEN_KEEPALIVE
+int get_sudoku_candidates(const int* puzzlePtr, int dim, int* candidatesPtr) {
+    // Masks use at most bit 25, so they are the same as ints
+    return kernel_candidates(puzzlePtr, dim, (uint32_t*)candidatesPtr) ? 1 : 0;
+}
+
+/**
+ * @brief Check whether this module was built with SIMD128 kernels
+ * 
+ * This function is exported to JavaScript so the loader can confirm which
+ * build variant it picked.
+ * 
+ * @return 1 for the SIMD build, 0 for the scalar one
+ */
+EMSCRIPTEN_KEEPALIVE
+int sudoku_simd_enabled(void) {
+    return kernels_use_simd() ? 1 : 0;
+}
+
 /**
  * @brief Get the difficulty level of a Sudoku puzzle
  * 
@@ -135,4 +280,232 @@ int get_sudoku_difficulty(const int* puzzlePtr, int dim) {
 EMSCRIPTEN_KEEPALIVE
 int generate_sudoku(int* puzzlePtr, int dim, int difficulty) {
     return generate_puzzle(puzzlePtr, dim, difficulty) ? 1 : 0;
+}
+
+/**
+ * @brief Solve a batch of Sudoku puzzles across the worker pool
+ * 
+ * This function is exported to JavaScript and solves n puzzles stored back
+ * to back. In the single-threaded build it runs on the calling thread.
+ * 
+ * @param puzzlesPtr Pointer to n * dim * dim puzzle cells in the WASM memory
+ * @param n Number of puzzles
+ * @param dim Dimension of the puzzles (e.g., 9 for 9x9 puzzles)
+ * @param solutionsPtr Pointer to n * dim * dim solution cells in the WASM memory
+ * @param numThreads Number of threads to use, 0 or less for one per logical core
+ * @return Number of puzzles solved
+ */
+EMSCRIPTEN_KEEPALIVE
+int solve_sudoku_batch(const int* puzzlesPtr, int n, int dim, int* solutionsPtr, int numThreads) {
+    return solve_many(puzzlesPtr, n, dim, solutionsPtr, NULL, resolve_threads(numThreads));
+}
+
+/**
+ * @brief Count the solutions of a Sudoku puzzle up to a limit across the worker pool
+ * 
+ * This function is exported to JavaScript and splits the search tree of one
+ * puzzle between threads, for counts too large for count_sudoku_solutions
+ * to finish quickly.
+ * 
+ * @param puzzlePtr Pointer to the puzzle array in the WASM memory
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param limit Maximum number of solutions to count (must be positive)
+ * @param numThreads Number of threads to use, 0 or less for one per logical core
+ * @return Number of solutions found, at most limit
+ */
+EMSCRIPTEN_KEEPALIVE
+int count_sudoku_solutions_parallel(const int* puzzlePtr, int dim, int limit, int numThreads) {
+    // A non-positive limit would mean no limit, which can overflow the int result
+    if (limit < 1) return 0;
+    return (int)count_solutions_parallel(puzzlePtr, dim, limit, resolve_threads(numThreads));
+}
+
+/**
+ * @brief Generate a Sudoku puzzle with the specified difficulty across the worker pool
+ * 
+ * This function is exported to JavaScript and checks candidate cell
+ * removals on several threads at once.
+ * 
+ * @param puzzlePtr Pointer to store the generated puzzle in the WASM memory
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param difficulty Difficulty level (1=Easy, 2=Medium, 3=Hard, 4=Expert, 5=Evil)
+ * @param numThreads Number of threads to use, 0 or less for one per logical core
+ * @return 1 if a puzzle is successfully generated, 0 otherwise
+ */
+EMSCRIPTEN_KEEPALIVE
+int generate_sudoku_parallel(int* puzzlePtr, int dim, int difficulty, int numThreads) {
+    return generate_puzzle_parallel(puzzlePtr, dim, difficulty, resolve_threads(numThreads)) ? 1 : 0;
+}
+
+/**
+ * @brief Solve byte-packed Sudoku boards in one call
+ * 
+ * This function is exported to JavaScript and solves n boards stored back
+ * to back, one byte per cell (0 for empty cells), replacing a set/get call
+ * per cell with one copy into and out of a heap view. A board with a byte
+ * past dim is unsolvable.
+ * 
+ * @param puzzlesPtr Pointer to n * dim * dim puzzle bytes in the WASM memory
+ * @param n Number of boards
+ * @param dim Dimension of the boards (e.g., 9 for 9x9 boards)
+ * @param solutionsPtr Pointer to n * dim * dim bytes receiving the solutions, all 0 for an unsolvable board
+ * @param numThreads Number of threads to use, 0 or less for one per logical core
+ * @return Number of boards solved, 0 if dim is past 255 (cells no longer fit a byte), -1 if out of memory
+ */
+EMSCRIPTEN_KEEPALIVE
+int solve_sudoku_boards(const uint8_t* puzzlesPtr, int n, int dim, uint8_t* solutionsPtr, int numThreads) {
+    if (n < 1 || dim < 1 || dim > UINT8_MAX) return 0;
+    size_t board_cells = (size_t)dim * dim;
+    size_t num_cells = board_cells * n;
+
+    int* puzzles = (int*)malloc(num_cells * sizeof(int));
+    int* solutions = (int*)malloc(num_cells * sizeof(int));
+    search_status* status = (search_status*)malloc(n * sizeof(search_status));
+    if (!puzzles || !solutions || !status) {
+        free(puzzles);
+        free(solutions);
+        free(status);
+        return -1;
+    }
+    unpack_boards(puzzlesPtr, num_cells, puzzles);
+
+    int solved = solve_many(puzzles, n, dim, solutions, status, resolve_threads(numThreads));
+    pack_boards(solutions, num_cells, solutionsPtr);
+
+    for (int i = 0; i < n; i++) {
+        if (status[i] != SEARCH_SOLVED) memset(solutionsPtr + board_cells * i, 0, board_cells);
+    }
+
+    free(puzzles);
+    free(solutions);
+    free(status);
+    return solved;
+}
+
+/**
+ * @brief Validate byte-packed Sudoku boards in one call
+ * 
+ * This function is exported to JavaScript and checks n completed boards
+ * stored back to back, one byte per cell. A board with a byte past dim is
+ * invalid.
+ * 
+ * @param boardsPtr Pointer to n * dim * dim board bytes in the WASM memory
+ * @param n Number of boards
+ * @param dim Dimension of the boards (e.g., 9 for 9x9 boards)
+ * @param resultsPtr Pointer to n bytes receiving 1 for a valid board and 0 otherwise
+ * @return Number of valid boards, 0 if dim is past 255 (cells no longer fit a byte), -1 if out of memory
+ */
+EMSCRIPTEN_KEEPALIVE
+int validate_sudoku_boards(const uint8_t* boardsPtr, int n, int dim, uint8_t* resultsPtr) {
+    if (n < 1 || dim < 1 || dim > UINT8_MAX) return 0;
+    size_t board_cells = (size_t)dim * dim;
+
+    int* boards = (int*)malloc(board_cells * n * sizeof(int));
+    if (!boards) return -1;
+    unpack_boards(boardsPtr, board_cells * n, boards);
+
+    int valid = 0;
+    for (int i = 0; i < n; i++) {
+        resultsPtr[i] = validate_solution(boards + board_cells * i, dim) ? 1 : 0;
+        valid += resultsPtr[i];
+    }
+
+    free(boards);
+    return valid;
+}
+
+/**
+ * @brief Count the solutions of byte-packed Sudoku boards up to a limit in one call
+ * 
+ * This function is exported to JavaScript and counts the solutions of n
+ * puzzles stored back to back, one byte per cell (0 for empty cells). A
+ * board with a byte past dim has no solutions.
+ * 
+ * @param puzzlesPtr Pointer to n * dim * dim puzzle bytes in the WASM memory
+ * @param n Number of boards
+ * @param dim Dimension of the boards (e.g., 9 for 9x9 boards)
+ * @param limit Maximum number of solutions to count per board (must be positive)
+ * @param countsPtr Pointer to n ints receiving the solution count of each board
+ * @param numThreads Number of threads to use, 0 or less for one per logical core
+ * @return Number of boards with at least one solution, 0 if dim is past 255 (cells no longer fit a byte), -1 if out of memory
+ */
+EMSCRIPTEN_KEEPALIVE
+int count_sudoku_boards(const uint8_t* puzzlesPtr, int n, int dim, int limit, int* countsPtr, int numThreads) {
+    // A non-positive limit would mean no limit, which can overflow the int counts
+    if (n < 1 || dim < 1 || dim > UINT8_MAX || limit < 1) return 0;
+
+    size_t num_cells = (size_t)dim * dim * n;
+    int* puzzles = (int*)malloc(num_cells * sizeof(int));
+    long long* counts = (long long*)malloc(n * sizeof(long long));
+    if (!puzzles || !counts) {
+        free(puzzles);
+        free(counts);
+        return -1;
+    }
+    unpack_boards(puzzlesPtr, num_cells, puzzles);
+
+    int solvable = count_many(puzzles, n, dim, limit, counts, resolve_threads(numThreads));
+    for (int i = 0; i < n; i++) {
+        countsPtr[i] = (int)counts[i];
+    }
+
+    free(puzzles);
+    free(counts);
+    return solvable;
+}
+
+/**
+ * @brief Get the number of threads the parallel functions use by default
+ * 
+ * This function is exported to JavaScript so the loader can confirm which
+ * build variant it picked.
+ * 
+ * @return Number of logical cores in the pthreads build, 1 otherwise
+ */
+EMSCRIPTEN_KEEPALIVE
+int sudoku_thread_count(void) {
+    return resolve_threads(0);
+}
+
+/**
+ * @brief Turn a requested thread count into the one to run with
+ * @param numThreads Requested number of threads, 0 or less for the default
+ * @return numThreads if positive, else the logical core count in the pthreads build and 1 otherwise
+ */
+static int resolve_threads(int numThreads) {
+    if (numThreads > 0) return numThreads;
+#ifdef __EMSCRIPTEN_PTHREADS__
+    int cores = emscripten_num_logical_cores();
+    return cores > 0 ? cores : 1;
+#else
+    return 1;
+#endif
+}
+
+/**
+ * @brief Widen byte-packed cells into the int cells the solver works on
+ *
+ * Bytes are not range checked here: the solver and validate_solution
+ * reject any board with a cell past dim.
+ *
+ * @param boards Cells, one byte each
+ * @param num_cells Number of cells
+ * @param cells Receives the cells as ints
+ */
+static void unpack_boards(const uint8_t* boards, size_t num_cells, int* cells) {
+    for (size_t i = 0; i < num_cells; i++) {
+        cells[i] = boards[i];
+    }
+}
+
+/**
+ * @brief Narrow int cells into byte-packed cells
+ * @param cells Cells, values 0 to 255
+ * @param num_cells Number of cells
+ * @param boards Receives the cells, one byte each
+ */
+static void pack_boards(const int* cells, size_t num_cells, uint8_t* boards) {
+    for (size_t i = 0; i < num_cells; i++) {
+        boards[i] = (uint8_t)cells[i];
+    }
 }
\ No newline at end of file
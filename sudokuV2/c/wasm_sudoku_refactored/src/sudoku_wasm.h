@@ -7,11 +7,15 @@
  */
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Number of doubles written by solve_sudoku_stats
+#define SUDOKU_STATS_LENGTH 8
+
 /**
  * @brief Solve a Sudoku puzzle and return the solution
  * 
@@ -23,8 +27,23 @@ extern "C" {
  * @param solutionPtr Pointer to the solution array in the WASM memory
  * @return 1 if a solution is found, 0 otherwise
  */
-int solve_sudoku(const int* puzzlePtr, int dim, int* solutionPtr)
+int solve_sudoku(const int* puzzlePtr, int dim, int* solutionPtr);
 
+/**
+ * @brief Solve a Sudoku puzzle and report the work the search took
+ * 
+ * This function is exported to JavaScript and solves a Sudoku puzzle like
+ * solve_sudoku, writing SUDOKU_STATS_LENGTH values to statsPtr in this
+ * order: search nodes, cover calls, uncover calls, links touched,
+ * backtracks, maximum depth, build time and search time (microseconds).
+ * 
+ * @param puzzlePtr Pointer to the Sudoku puzzle array in the WASM memory
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param solutionPtr Pointer to the solution array in the WASM memory
+ * @param statsPtr Pointer to SUDOKU_STATS_LENGTH doubles in the WASM memory
+ * @return 1 if a solution is found, 0 otherwise
+ */
+int solve_sudoku_stats(const int* puzzlePtr, int dim, int* solutionPtr, double* statsPtr);
 
 /**
  * @brief Allocate memory for a Sudoku puzzle or solution
@@ -47,6 +66,49 @@ int* allocate_sudoku_array(int dim);
  */
 void free_sudoku_array(int* ptr);
 
+/**
+ * @brief Allocate memory for the statistics of solve_sudoku_stats
+ * 
+ * This function is exported to JavaScript and allocates SUDOKU_STATS_LENGTH
+ * doubles in the WASM memory.
+ * 
+ * @return Pointer to the allocated memory
+ */
+double* allocate_sudoku_stats(void);
+
+/**
+ * @brief Free memory allocated for solve_sudoku_stats statistics
+ * 
+ * This function is exported to JavaScript and frees memory allocated by
+ * allocate_sudoku_stats.
+ * 
+ * @param ptr Pointer to the memory to free
+ */
+void free_sudoku_stats(double* ptr);
+
+/**
+ * @brief Allocate memory for byte-packed Sudoku boards
+ * 
+ * This function is exported to JavaScript and allocates n boards of
+ * dim * dim bytes each, back to back, for the *_sudoku_boards functions.
+ * JavaScript reads and writes them through a Uint8Array view of the heap.
+ * 
+ * @param dim Dimension of the boards (e.g., 9 for 9x9 boards)
+ * @param n Number of boards
+ * @return Pointer to the allocated memory, NULL if out of memory
+ */
+uint8_t* allocate_sudoku_boards(int dim, int n);
+
+/**
+ * @brief Free memory allocated for byte-packed Sudoku boards
+ * 
+ * This function is exported to JavaScript and frees memory allocated by
+ * allocate_sudoku_boards.
+ * 
+ * @param ptr Pointer to the memory to free
+ */
+void free_sudoku_boards(uint8_t* ptr);
+
 /**
  * @brief Set a value in a Sudoku puzzle or solution
  * 
@@ -94,6 +156,42 @@ int validate_sudoku(const int* solutionPtr, int dim);
  */
 int has_unique_sudoku_solution(const int* puzzlePtr, int dim);
 
+/**
+ * @brief Count the solutions of a Sudoku puzzle up to a limit
+ * 
+ * This function is exported to JavaScript and counts the solutions of a
+ * Sudoku puzzle, stopping as soon as limit solutions have been found.
+ * 
+ * @param puzzlePtr Pointer to the puzzle array in the WASM memory
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param limit Maximum number of solutions to count (must be positive)
+ * @return Number of solutions found, at most limit
+ */
+int count_sudoku_solutions(const int* puzzlePtr, int dim, int limit);
+
+/**
+ * @brief Compute the candidate values of every empty cell of a puzzle
+ * 
+ * This function is exported to JavaScript and writes one bit mask per cell:
+ * bit v is set if value v can still go in that cell. Filled cells get 0.
+ * 
+ * @param puzzlePtr Pointer to the puzzle array in the WASM memory
+ * @param dim Dimension of the puzzle (at most 25)
+ * @param candidatesPtr Pointer to an array of dim * dim ints in the WASM memory
+ * @return 1 on success, 0 if the puzzle is malformed or too large
+ */
+int get_sudoku_candidates(const int* puzzlePtr, int dim, int* candidatesPtr);
+
+/**
+ * @brief Check whether this module was built with SIMD128 kernels
+ * 
+ * This function is exported to JavaScript so the loader can confirm which
+ * build variant it picked.
+ * 
+ * @return 1 for the SIMD build, 0 for the scalar one
+ */
+int sudoku_simd_enabled(void);
+
 /**
  * @brief Get the difficulty level of a Sudoku puzzle
  * 
@@ -119,6 +217,109 @@ int get_sudoku_difficulty(const int* puzzlePtr, int dim);
  */
 int generate_sudoku(int* puzzlePtr, int dim, int difficulty);
 
+/**
+ * @brief Solve a batch of Sudoku puzzles across the worker pool
+ * 
+ * This function is exported to JavaScript and solves n puzzles stored back
+ * to back. In the single-threaded build it runs on the calling thread.
+ * 
+ * @param puzzlesPtr Pointer to n * dim * dim puzzle cells in the WASM memory
+ * @param n Number of puzzles
+ * @param dim Dimension of the puzzles (e.g., 9 for 9x9 puzzles)
+ * @param solutionsPtr Pointer to n * dim * dim solution cells in the WASM memory
+ * @param numThreads Number of threads to use, 0 or less for one per logical core
+ * @return Number of puzzles solved
+ */
+int solve_sudoku_batch(const int* puzzlesPtr, int n, int dim, int* solutionsPtr, int numThreads);
+
+/**
+ * @brief Count the solutions of a Sudoku puzzle up to a limit across the worker pool
+ * 
+ * This function is exported to JavaScript and splits the search tree of one
+ * puzzle between threads, for counts too large for count_sudoku_solutions
+ * to finish quickly.
+ * 
+ * @param puzzlePtr Pointer to the puzzle array in the WASM memory
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param limit Maximum number of solutions to count (must be positive)
+ * @param numThreads Number of threads to use, 0 or less for one per logical core
+ * @return Number of solutions found, at most limit
+ */
+int count_sudoku_solutions_parallel(const int* puzzlePtr, int dim, int limit, int numThreads);
+
+/**
+ * @brief Generate a Sudoku puzzle with the specified difficulty across the worker pool
+ * 
+ * This function is exported to JavaScript and checks candidate cell
+ * removals on several threads at once.
+ * 
+ * @param puzzlePtr Pointer to store the generated puzzle in the WASM memory
+ * @param dim Dimension of the puzzle (e.g., 9 for a 9x9 puzzle)
+ * @param difficulty Difficulty level (1=Easy, 2=Medium, 3=Hard, 4=Expert, 5=Evil)
+ * @param numThreads Number of threads to use, 0 or less for one per logical core
+ * @return 1 if a puzzle is successfully generated, 0 otherwise
+ */
+int generate_sudoku_parallel(int* puzzlePtr, int dim, int difficulty, int numThreads);
+
+/**
+ * @brief Solve byte-packed Sudoku boards in one call
+ * 
+ * This function is exported to JavaScript and solves n boards stored back
+ * to back, one byte per cell (0 for empty cells), replacing a set/get call
+ * per cell with one copy into and out of a heap view. A board with a byte
+ * past dim is unsolvable.
+ * 
+ * @param puzzlesPtr Pointer to n * dim * dim puzzle bytes in the WASM memory
+ * @param n Number of boards
+ * @param dim Dimension of the boards (e.g., 9 for 9x9 boards)
+ * @param solutionsPtr Pointer to n * dim * dim bytes receiving the solutions, all 0 for an unsolvable board
+ * @param numThreads Number of threads to use, 0 or less for one per logical core
+ * @return Number of boards solved, 0 if dim is past 255 (cells no longer fit a byte), -1 if out of memory
+ */
+int solve_sudoku_boards(const uint8_t* puzzlesPtr, int n, int dim, uint8_t* solutionsPtr, int numThreads);
+
+/**
+ * @brief Validate byte-packed Sudoku boards in one call
+ * 
+ * This function is exported to JavaScript and checks n completed boards
+ * stored back to back, one byte per cell. A board with a byte past dim is
+ * invalid.
+ * 
+ * @param boardsPtr Pointer to n * dim * dim board bytes in the WASM memory
+ * @param n Number of boards
+ * @param dim Dimension of the boards (e.g., 9 for 9x9 boards)
+ * @param resultsPtr Pointer to n bytes receiving 1 for a valid board and 0 otherwise
+ * @return Number of valid boards, 0 if dim is past 255 (cells no longer fit a byte), -1 if out of memory
+ */
+int validate_sudoku_boards(const uint8_t* boardsPtr, int n, int dim, uint8_t* resultsPtr);
+
+/**
+ * @brief Count the solutions of byte-packed Sudoku boards up to a limit in one call
+ * 
+ * This function is exported to JavaScript and counts the solutions of n
+ * puzzles stored back to back, one byte per cell (0 for empty cells). A
+ * board with a byte past dim has no solutions.
+ * 
+ * @param puzzlesPtr Pointer to n * dim * dim puzzle bytes in the WASM memory
+ * @param n Number of boards
+ * @param dim Dimension of the boards (e.g., 9 for 9x9 boards)
+ * @param limit Maximum number of solutions to count per board (must be positive)
+ * @param countsPtr Pointer to n ints receiving the solution count of each board
+ * @param numThreads Number of threads to use, 0 or less for one per logical core
+ * @return Number of boards with at least one solution, 0 if dim is past 255 (cells no longer fit a byte), -1 if out of memory
+ */
+int count_sudoku_boards(const uint8_t* puzzlesPtr, int n, int dim, int limit, int* countsPtr, int numThreads);
+
+/**
+ * @brief Get the number of threads the parallel functions use by default
+ * 
+ * This function is exported to JavaScript so the loader can confirm which
+ * build variant it picked.
+ * 
+ * @return Number of logical cores in the pthreads build, 1 otherwise
+ */
+int sudoku_thread_count(void);
+
 #ifdef __cplusplus
 }
 #endif
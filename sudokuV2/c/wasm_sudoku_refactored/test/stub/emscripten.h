@@ -0,0 +1,11 @@
+#ifndef EMSCRIPTEN_STUB_H
+#define EMSCRIPTEN_STUB_H
+
+/**
+ * @file emscripten.h
+ * @brief Stand-in for the Emscripten header so the WASM bindings build natively for tests
+ */
+
+#define EMSCRIPTEN_KEEPALIVE
+
+#endif /* EMSCRIPTEN_STUB_H */
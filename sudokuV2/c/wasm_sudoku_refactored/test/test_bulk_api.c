@@ -0,0 +1,94 @@
+#include <stdio.h>
+#include <string.h>
+#include "sudoku_core.h"
+#include "sudoku_wasm.h"
+
+// Puzzle with a unique solution (first line of bench/data/easy.txt)
+static const char* PUZZLE = "52.7..18...9.....5681.2.......3.2.5936......19541.82....721.5......35798.35.....2";
+
+static int failures = 0;
+
+// Forward declarations of helper functions
+static void check(bool ok, const char* what);
+static void load_puzzle(uint8_t* board);
+static bool all_zero(const uint8_t* board, int num_cells);
+
+/**
+ * @brief Check that the byte-packed bulk API rejects boards with a cell past dim
+ * @return 0 if every check passed, 1 otherwise
+ */
+int main(void) {
+    const int n = 4, dim = 9, num_cells = 81;
+    uint8_t* puzzles = allocate_sudoku_boards(dim, n);
+    uint8_t* solutions = allocate_sudoku_boards(dim, n);
+    uint8_t results[4];
+    int counts[4];
+
+    // Board 0 is well formed, the others each hold one byte past dim
+    for (int i = 0; i < n; i++) {
+        load_puzzle(puzzles + num_cells * i);
+    }
+    puzzles[num_cells * 1 + 2] = 10;
+    memset(puzzles + num_cells * 2, 0, num_cells);
+    puzzles[num_cells * 2 + num_cells - 1] = 10;
+    puzzles[num_cells * 3 + 2] = 255;
+
+    check(solve_sudoku_boards(puzzles, n, dim, solutions, 2) == 1, "only the well formed board is solved");
+    for (int i = 1; i < n; i++) {
+        check(all_zero(solutions + num_cells * i, num_cells), "an out of range board gets an all zero solution");
+    }
+
+    check(count_sudoku_boards(puzzles, n, dim, 2, counts, 2) == 1, "only the well formed board has solutions");
+    check(counts[0] == 1, "the well formed board has one solution");
+    for (int i = 1; i < n; i++) {
+        check(counts[i] == 0, "an out of range board has no solutions");
+    }
+
+    // The solved board with one cell bumped past dim must not validate
+    memcpy(solutions + num_cells, solutions, num_cells);
+    solutions[num_cells + 40] = 10;
+    check(validate_sudoku_boards(solutions, 2, dim, results) == 1, "only the solved board is valid");
+    check(results[0] == 1 && results[1] == 0, "an out of range board is invalid");
+
+    free_sudoku_boards(puzzles);
+    free_sudoku_boards(solutions);
+    free_matrix_templates();
+
+    if (failures == 0) printf("test_bulk_api: all checks passed\n");
+    return failures == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Record and report one check
+ * @param ok Result of the check
+ * @param what Description of what was expected
+ */
+static void check(bool ok, const char* what) {
+    if (ok) return;
+
+    printf("FAIL: %s\n", what);
+    failures++;
+}
+
+/**
+ * @brief Write PUZZLE into a byte-packed board
+ * @param board 81 bytes receiving the cells
+ */
+static void load_puzzle(uint8_t* board) {
+    for (int i = 0; i < 81; i++) {
+        board[i] = PUZZLE[i] == '.' ? 0 : (uint8_t)(PUZZLE[i] - '0');
+    }
+}
+
+/**
+ * @brief Check whether every cell of a board is 0
+ * @param board Byte-packed board
+ * @param num_cells Number of cells
+ * @return true if every cell is 0
+ */
+static bool all_zero(const uint8_t* board, int num_cells) {
+    for (int i = 0; i < num_cells; i++) {
+        if (board[i] != 0) return false;
+    }
+    return true;
+}
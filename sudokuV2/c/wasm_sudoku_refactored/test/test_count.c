@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <string.h>
+#include "sudoku_core.h"
+
+// Puzzle with a unique solution (first line of bench/data/easy.txt)
+static const char* PUZZLE = "52.7..18...9.....5681.2.......3.2.5936......19541.82....721.5......35798.35.....2";
+
+// Solved board with a deadly rectangle cleared: 6 and 7 at rows 1 and 4,
+// columns 4 and 5 span two boxes and can be swapped, so it has two solutions
+static const char* TWO_SOLUTIONS = "534..8912672195348198342567859..1423426853791713924856961537284287419635345286179";
+
+// Solved 4x4 boards: 288 in all
+#define EMPTY_4X4_SOLUTIONS 288
+
+/**
+ * @brief Solved boards reported by enumerate_solutions
+ */
+typedef struct {
+    int boards[EMPTY_4X4_SOLUTIONS][81];
+    const int* puzzle;          // Every board must keep these givens
+    int count;
+    int stop_after;             // Stop the enumeration after this many boards, 0 to never stop
+    bool all_valid;
+} board_list;
+
+static board_list found;
+static int failures = 0;
+
+// Forward declarations of helper functions
+static void check(bool ok, const char* what);
+static void load_puzzle(const char* cells, int* puzzle);
+static bool collect_board(const int* board, int dim, void* data);
+static bool all_distinct(const board_list* list, int num_cells);
+static void test_unique_puzzle(void);
+static void test_two_solutions(void);
+static void test_empty_4x4(void);
+static void test_early_stop(void);
+
+/**
+ * @brief Check count_solutions, enumerate_solutions and has_unique_solution on puzzles with known counts
+ * @return 0 if every check passed, 1 otherwise
+ */
+int main(void) {
+    test_unique_puzzle();
+    test_two_solutions();
+    test_empty_4x4();
+    test_early_stop();
+    free_matrix_templates();
+
+    if (failures == 0) printf("test_count: all checks passed\n");
+    return failures == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Record and report one check
+ * @param ok Result of the check
+ * @param what Description of what was expected
+ */
+static void check(bool ok, const char* what) {
+    if (ok) return;
+
+    printf("FAIL: %s\n", what);
+    failures++;
+}
+
+/**
+ * @brief Read a 9x9 puzzle string into a board
+ * @param cells 81 characters, digits for givens and '.' for empty cells
+ * @param puzzle 81 cells receiving the puzzle
+ */
+static void load_puzzle(const char* cells, int* puzzle) {
+    for (int i = 0; i < 81; i++) {
+        puzzle[i] = cells[i] == '.' ? 0 : cells[i] - '0';
+    }
+}
+
+/**
+ * @brief board_callback that keeps each board and checks it against the givens
+ * @param board Solved board
+ * @param dim Dimension of the board
+ * @param data Pointer to a board_list
+ * @return false once stop_after boards have been kept
+ */
+static bool collect_board(const int* board, int dim, void* data) {
+    board_list* list = (board_list*)data;
+    int num_cells = dim * dim;
+    if (list->count == EMPTY_4X4_SOLUTIONS) return false;
+
+    bool valid = validate_solution(board, dim);
+    for (int i = 0; i < num_cells; i++) {
+        if (list->puzzle[i] != 0 && board[i] != list->puzzle[i]) valid = false;
+    }
+    if (!valid) list->all_valid = false;
+
+    memcpy(list->boards[list->count++], board, sizeof(int) * num_cells);
+    return list->stop_after == 0 || list->count < list->stop_after;
+}
+
+/**
+ * @brief Check that no two kept boards are the same
+ * @param list Pointer to the board_list
+ * @param num_cells Number of cells of each board
+ * @return true if every board differs from every other
+ */
+static bool all_distinct(const board_list* list, int num_cells) {
+    for (int i = 0; i < list->count; i++) {
+        for (int j = i + 1; j < list->count; j++) {
+            if (memcmp(list->boards[i], list->boards[j], sizeof(int) * num_cells) == 0) return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief A puzzle with one solution counts 1 whatever the limit and enumerates its solution
+ */
+static void test_unique_puzzle(void) {
+    int puzzle[81], solution[81];
+    load_puzzle(PUZZLE, puzzle);
+
+    check(count_solutions(puzzle, 9, 1) == 1, "a unique puzzle counts 1 with limit 1");
+    check(count_solutions(puzzle, 9, 10) == 1, "a unique puzzle counts 1 with limit 10");
+    check(count_solutions(puzzle, 9, 0) == 1, "a unique puzzle counts 1 without a limit");
+    check(has_unique_solution(puzzle, 9), "a unique puzzle has a unique solution");
+
+    memset(&found, 0, sizeof(found));
+    found.puzzle = puzzle;
+    found.all_valid = true;
+    check(enumerate_solutions(puzzle, 9, 0, collect_board, &found) == 1, "a unique puzzle enumerates 1 board");
+    check(found.count == 1 && found.all_valid, "the enumerated board solves the puzzle");
+    check(solve_puzzle(puzzle, 9, solution) && memcmp(solution, found.boards[0], sizeof(solution)) == 0,
+          "the enumerated board is the one solve_puzzle finds");
+}
+
+/**
+ * @brief A puzzle with two solutions counts up to the limit and enumerates both
+ */
+static void test_two_solutions(void) {
+    int puzzle[81];
+    load_puzzle(TWO_SOLUTIONS, puzzle);
+
+    check(count_solutions(puzzle, 9, 1) == 1, "a two solution puzzle counts 1 with limit 1");
+    check(count_solutions(puzzle, 9, 2) == 2, "a two solution puzzle counts 2 with limit 2");
+    check(count_solutions(puzzle, 9, 10) == 2, "a two solution puzzle counts 2 with limit 10");
+    check(count_solutions(puzzle, 9, 0) == 2, "a two solution puzzle counts 2 without a limit");
+    check(!has_unique_solution(puzzle, 9), "a two solution puzzle has no unique solution");
+
+    memset(&found, 0, sizeof(found));
+    found.puzzle = puzzle;
+    found.all_valid = true;
+    check(enumerate_solutions(puzzle, 9, 10, collect_board, &found) == 2, "a two solution puzzle enumerates 2 boards");
+    check(found.count == 2 && found.all_valid && all_distinct(&found, 81), "both boards solve the puzzle and differ");
+
+    memset(&found, 0, sizeof(found));
+    found.puzzle = puzzle;
+    check(enumerate_solutions(puzzle, 9, 1, collect_board, &found) == 1 && found.count == 1,
+          "a limit of 1 enumerates 1 board");
+}
+
+/**
+ * @brief An empty 4x4 board has 288 solutions, all enumerated and distinct
+ */
+static void test_empty_4x4(void) {
+    int puzzle[16] = { 0 };
+
+    check(count_solutions(puzzle, 4, 0) == EMPTY_4X4_SOLUTIONS, "an empty 4x4 board has 288 solutions");
+    check(count_solutions(puzzle, 4, 100) == 100, "a limit caps the count of an empty 4x4 board");
+    check(count_solutions_parallel(puzzle, 4, 0, 4) == EMPTY_4X4_SOLUTIONS,
+          "a parallel count of an empty 4x4 board finds 288 solutions");
+    check(!has_unique_solution(puzzle, 4), "an empty 4x4 board has no unique solution");
+
+    memset(&found, 0, sizeof(found));
+    found.puzzle = puzzle;
+    found.all_valid = true;
+    check(enumerate_solutions(puzzle, 4, 0, collect_board, &found) == EMPTY_4X4_SOLUTIONS,
+          "an empty 4x4 board enumerates 288 boards");
+    check(found.all_valid && all_distinct(&found, 16), "the 288 boards are valid and distinct");
+}
+
+/**
+ * @brief A callback returning false stops the enumeration
+ */
+static void test_early_stop(void) {
+    int puzzle[16] = { 0 };
+
+    memset(&found, 0, sizeof(found));
+    found.puzzle = puzzle;
+    found.stop_after = 3;
+    long long reported = enumerate_solutions(puzzle, 4, 0, collect_board, &found);
+    check(found.count == 3, "the callback is not called after it returns false");
+    check(reported == 3, "the enumeration reports the boards passed before it stopped");
+}
@@ -0,0 +1,358 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "exact_cover.h"
+
+// Knuth's 7 column example from "Dancing Links", columns A to G as 0 to 6;
+// its only exact cover is rows 0, 3 and 4
+static const int KNUTH_OFFSETS[] = { 0, 3, 6, 9, 11, 13, 16 };
+static const int KNUTH_COLUMNS[] = { 2, 4, 5,  0, 3, 6,  1, 2, 5,  0, 3,  1, 6,  3, 4, 6 };
+
+// Largest generated XCC problem, small enough to try every subset of rows
+#define XCC_MAX_ROWS 14
+#define XCC_MAX_COLS 8
+
+/**
+ * @brief XCC problem as the sparse row list given to create_exact_cover_xcc
+ */
+typedef struct {
+    int num_rows, num_primary, num_secondary;
+    int offsets[XCC_MAX_ROWS + 1];
+    int columns[XCC_MAX_ROWS * XCC_MAX_COLS];
+    int colors[XCC_MAX_ROWS * XCC_MAX_COLS];
+} xcc_problem;
+
+/**
+ * @brief State for checking each reported cover against the brute force rules
+ */
+typedef struct {
+    const xcc_problem* problem;
+    bool all_valid;
+} cover_check;
+
+static int failures = 0;
+
+// Forward declarations of helper functions
+static void check(bool ok, const char* what);
+static ExactCover* create_queens(int n);
+static void test_queens(void);
+static void test_knuth_example(void);
+static void test_empty_matrix(void);
+static void test_empty_column(void);
+static bool valid_cover(const xcc_problem* problem, unsigned mask);
+static long long brute_force_count(const xcc_problem* problem);
+static bool check_cover(const int* rows, int num_rows, void* data);
+static void check_xcc(const xcc_problem* problem, long long expected, const char* what);
+static void test_uncovered_secondary(void);
+static void test_agreeing_colors(void);
+static void test_conflicting_colors(void);
+static void test_random_xcc(void);
+
+/**
+ * @brief Check exact cover counts on problems with known answers
+ * @return 0 if every check passed, 1 otherwise
+ */
+int main(void) {
+    test_queens();
+    test_knuth_example();
+    test_empty_matrix();
+    test_empty_column();
+    test_uncovered_secondary();
+    test_agreeing_colors();
+    test_conflicting_colors();
+    test_random_xcc();
+
+    if (failures == 0) printf("test_exact_cover: all checks passed\n");
+    return failures == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Record and report one check
+ * @param ok Result of the check
+ * @param what Description of what was expected
+ */
+static void check(bool ok, const char* what) {
+    if (ok) return;
+
+    printf("FAIL: %s\n", what);
+    failures++;
+}
+
+/**
+ * @brief Build N-queens as exact cover
+ *
+ * Ranks and files are primary columns, 0 to 2n - 1, and the 2 * (2n - 1)
+ * diagonals secondary ones, since a diagonal may stay empty.
+ *
+ * @param n Board size
+ * @return Pointer to the new problem, NULL if out of memory
+ */
+static ExactCover* create_queens(int n) {
+    int num_rows = n * n;
+    int* offsets = (int*)malloc(sizeof(int) * (num_rows + 1));
+    int* columns = (int*)malloc(sizeof(int) * num_rows * 4);
+    if (!offsets || !columns) {
+        free(offsets);
+        free(columns);
+        return NULL;
+    }
+
+    for (int r = 0; r < n; r++) {
+        for (int c = 0; c < n; c++) {
+            int row = r * n + c;
+            offsets[row] = row * 4;
+            columns[row * 4] = r;
+            columns[row * 4 + 1] = n + c;
+            columns[row * 4 + 2] = 2 * n + r + c;
+            columns[row * 4 + 3] = 2 * n + (2 * n - 1) + (r - c + n - 1);
+        }
+    }
+    offsets[num_rows] = num_rows * 4;
+
+    ExactCover* ec = create_exact_cover_xcc(num_rows, 2 * n, 2 * (2 * n - 1), offsets, columns, NULL);
+    free(offsets);
+    free(columns);
+    return ec;
+}
+
+/**
+ * @brief 8-queens has 92 solutions, each reported with 8 rows
+ */
+static void test_queens(void) {
+    ExactCover* ec = create_queens(8);
+    check(ec != NULL, "8-queens builds");
+    if (!ec) return;
+
+    check(exact_cover_count(ec, 0) == 92, "8-queens has 92 covers");
+    check(exact_cover_count(ec, 10) == 10, "a limit caps the count");
+
+    int rows[16];
+    int num_chosen = 0;
+    check(exact_cover_solve(ec, rows, &num_chosen) && num_chosen == 8, "an 8-queens cover places 8 queens");
+
+    // Counting again after a solve must give the same answer
+    check(exact_cover_count(ec, 0) == 92, "a solve leaves the problem as it found it");
+    delete_exact_cover(ec);
+}
+
+/**
+ * @brief Knuth's example has exactly one cover, rows 0, 3 and 4
+ */
+static void test_knuth_example(void) {
+    ExactCover* ec = create_exact_cover(6, 7, KNUTH_OFFSETS, KNUTH_COLUMNS);
+    check(ec != NULL, "Knuth's example builds");
+    if (!ec) return;
+
+    check(exact_cover_count(ec, 0) == 1, "Knuth's example has one cover");
+
+    int rows[7];
+    int num_chosen = 0;
+    bool solved = exact_cover_solve(ec, rows, &num_chosen);
+    check(solved && num_chosen == 3, "Knuth's cover has 3 rows");
+
+    int chosen = 0;
+    for (int i = 0; i < num_chosen; i++) {
+        chosen |= 1 << rows[i];
+    }
+    check(chosen == ((1 << 0) | (1 << 3) | (1 << 4)), "Knuth's cover is rows 0, 3 and 4");
+    delete_exact_cover(ec);
+}
+
+/**
+ * @brief A matrix without rows is rejected, and one whose rows are all empty has no covers
+ */
+static void test_empty_matrix(void) {
+    const int no_rows[] = { 0 };
+    const int no_columns[] = { 0 };
+    check(create_exact_cover(0, 3, no_rows, no_columns) == NULL, "a matrix without rows is rejected");
+    check(exact_cover_count(NULL, 0) == 0, "a missing problem has no covers");
+
+    const int empty_rows[] = { 0, 0, 0 };
+    ExactCover* ec = create_exact_cover(2, 3, empty_rows, no_columns);
+    check(ec != NULL, "a matrix of empty rows builds");
+    if (!ec) return;
+
+    int rows[3];
+    int num_chosen = 0;
+    check(exact_cover_count(ec, 0) == 0, "a matrix of empty rows has no covers");
+    check(!exact_cover_solve(ec, rows, &num_chosen) && num_chosen == 0, "a matrix of empty rows has no solution");
+    delete_exact_cover(ec);
+}
+
+/**
+ * @brief Knuth's example with an eighth column no row touches has no covers
+ */
+static void test_empty_column(void) {
+    ExactCover* ec = create_exact_cover(6, 8, KNUTH_OFFSETS, KNUTH_COLUMNS);
+    check(ec != NULL, "Knuth's example with an empty column builds");
+    if (!ec) return;
+
+    check(exact_cover_count(ec, 0) == 0, "an empty column leaves no covers");
+    delete_exact_cover(ec);
+}
+
+/**
+ * @brief Check a set of rows against the XCC rules
+ *
+ * Every primary column must be covered exactly once. A secondary column may
+ * stay uncovered, be covered by one uncolored entry, or be shared by any
+ * number of entries of one color. A row with no primary column is never
+ * part of a cover.
+ *
+ * @param problem Pointer to the problem
+ * @param mask Bit r set if row r is chosen
+ * @return true if the rows form a cover
+ */
+static bool valid_cover(const xcc_problem* problem, unsigned mask) {
+    int count[XCC_MAX_COLS] = { 0 };
+    int color[XCC_MAX_COLS] = { 0 };
+
+    for (int r = 0; r < problem->num_rows; r++) {
+        if (!(mask & (1u << r))) continue;
+
+        bool has_primary = false;
+        for (int i = problem->offsets[r]; i < problem->offsets[r + 1]; i++) {
+            int col = problem->columns[i];
+            int c = problem->colors[i];
+            if (col < problem->num_primary) has_primary = true;
+
+            if (count[col] > 0 && (c == 0 || color[col] != c)) return false;
+            count[col]++;
+            color[col] = c;
+        }
+        if (!has_primary) return false;
+    }
+
+    for (int col = 0; col < problem->num_primary; col++) {
+        if (count[col] != 1) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Count the covers of a problem by trying every subset of rows
+ * @param problem Pointer to the problem
+ * @return Number of covers
+ */
+static long long brute_force_count(const xcc_problem* problem) {
+    long long count = 0;
+    for (unsigned mask = 0; mask < (1u << problem->num_rows); mask++) {
+        if (valid_cover(problem, mask)) count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Check one reported cover against the brute force rules
+ * @param rows Row ids of the cover
+ * @param num_rows Number of rows in the cover
+ * @param data Pointer to a cover_check
+ * @return true to keep searching
+ */
+static bool check_cover(const int* rows, int num_rows, void* data) {
+    cover_check* state = (cover_check*)data;
+
+    unsigned mask = 0;
+    for (int i = 0; i < num_rows; i++) {
+        mask |= 1u << rows[i];
+    }
+    if (!valid_cover(state->problem, mask)) state->all_valid = false;
+    return true;
+}
+
+/**
+ * @brief Check that the search and brute force agree on a problem
+ * @param problem Pointer to the problem
+ * @param expected Known number of covers, -1 to rely on brute force alone
+ * @param what Description of the problem
+ */
+static void check_xcc(const xcc_problem* problem, long long expected, const char* what) {
+    long long brute = brute_force_count(problem);
+    if (expected >= 0 && brute != expected) {
+        printf("FAIL: brute force finds %lld covers, not %lld: %s\n", brute, expected, what);
+        failures++;
+    }
+
+    ExactCover* ec = create_exact_cover_xcc(problem->num_rows, problem->num_primary, problem->num_secondary,
+                                           problem->offsets, problem->columns, problem->colors);
+    check(ec != NULL, what);
+    if (!ec) return;
+
+    cover_check state = { problem, true };
+    long long counted = exact_cover_count(ec, 0);
+    long long reported = exact_cover_enumerate(ec, 0, check_cover, &state);
+    if (counted != brute || reported != brute || !state.all_valid) {
+        printf("FAIL: %lld counted, %lld reported, %lld by brute force: %s\n", counted, reported, brute, what);
+        failures++;
+    }
+    delete_exact_cover(ec);
+}
+
+/**
+ * @brief A secondary column may stay uncovered but not be covered twice
+ */
+static void test_uncovered_secondary(void) {
+    // Primary 0 and 1, secondary 2; rows {0, 2}, {1}, {0}, {1, 2}
+    xcc_problem problem = {
+        4, 2, 1,
+        { 0, 2, 3, 4, 6 },
+        { 0, 2,  1,  0,  1, 2 },
+        { 0 }
+    };
+    check_xcc(&problem, 3, "a secondary column may stay uncovered");
+}
+
+/**
+ * @brief Two rows giving a secondary column the same color may share it
+ */
+static void test_agreeing_colors(void) {
+    // Rows {0, 2:1}, {1, 2:1}, {0}, {1}: the first two may combine
+    xcc_problem problem = {
+        4, 2, 1,
+        { 0, 2, 4, 5, 6 },
+        { 0, 2,  1, 2,  0,  1 },
+        { 0, 1,  0, 1,  0,  0 }
+    };
+    check_xcc(&problem, 4, "rows agreeing on a color combine");
+}
+
+/**
+ * @brief Two rows giving a secondary column different colors may not share it
+ */
+static void test_conflicting_colors(void) {
+    // Rows {0, 2:1}, {1, 2:2}, {0}, {1}: the first two conflict
+    xcc_problem problem = {
+        4, 2, 1,
+        { 0, 2, 4, 5, 6 },
+        { 0, 2,  1, 2,  0,  1 },
+        { 0, 1,  0, 2,  0,  0 }
+    };
+    check_xcc(&problem, 3, "rows conflicting on a color are rejected");
+}
+
+/**
+ * @brief Random XCC problems with uncolored and colored secondary entries agree with brute force
+ */
+static void test_random_xcc(void) {
+    unsigned seed = 12345;
+
+    for (int trial = 0; trial < 200; trial++) {
+        xcc_problem problem = { XCC_MAX_ROWS, 4, 4, { 0 }, { 0 }, { 0 } };
+        int length = 0;
+
+        for (int r = 0; r < problem.num_rows; r++) {
+            problem.offsets[r] = length;
+            for (int col = 0; col < problem.num_primary + problem.num_secondary; col++) {
+                seed = seed * 1103515245u + 12345u;
+                if ((seed >> 16) % 3 != 0) continue;
+
+                problem.columns[length] = col;
+                seed = seed * 1103515245u + 12345u;
+                problem.colors[length] = col < problem.num_primary ? 0 : (int)((seed >> 16) % 3);
+                length++;
+            }
+        }
+        problem.offsets[problem.num_rows] = length;
+
+        check_xcc(&problem, -1, "a random XCC problem agrees with brute force");
+    }
+}
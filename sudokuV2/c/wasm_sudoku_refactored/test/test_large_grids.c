@@ -0,0 +1,274 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sudoku_core.h"
+
+// First puzzles of bench/data/36x36_random_holes.txt and 49x49_random_holes.txt,
+// one grid row per line (values 10-35 as A-Z, 36-49 as a-n)
+static const char* PUZZLE_36 =
+    "ICJB..3..N.29..VADL.YGHR657.4EM.K..."
+    "....VD1..G..I.BT..a....X...WSME46.U5"
+    "Xa...27E....R1Y....QSKF..PJIBCAZV..D"
+    ".L.......K..X3.N.2E7.6..V..9ZAC...I."
+    ".E74..JCITB.W..KM..8Z.D..23X...Y.1RH"
+    "W..S.F8A9VZDU.46...J..PIG...YL.ON.X."
+    "...AD.4..H.1TYCP..XS.2..F.B.M....Z6."
+    "..Sa23ZU.5E.G4..R1W.M.QKPJ...I.A...."
+    "6U......T.C.KBMFW.9O..8V.3..aXR.H4.."
+    ".R....B...MQNS...3UZE.76D8OVA9ICP.TJ"
+    "TI..PJ..N2a3..A..8R4.H..57..EUWM.B.."
+    ".W.M.....D..6.E5U...CP.T.14.LR.a...."
+    ".45.U6P.C....F3W.KZD79VAXN....Y.RHLG"
+    "AZD79VH.LR.GCP..B...8X.a..FM3S..U5E."
+    ".O..X.5..U.6...RY..F3W....PCQBZ7.DA."
+    "M.F3WKD.A.7V..1U..BPQI.C...LJY.8.2.N"
+    "..PQ.T2OaX...D..ZVY.J.G..6.E1..3W.MK"
+    "LYHJRG...W3K..8.ON4..U6E.V.A7..QIPCT"
+    ".5..ZA.PJYT..IK.F...VO.8.M.3..HG4U1E"
+    "1.UG.E..QBKC3W.S2.59.ZA..aX8.D...R.."
+    "8D.V.aUH...EJ..YP.2WN..3.C.Q..5.Z97A"
+    ".2.NSM9...6.1.....F....QY.RJ.PDVOX.a"
+    "J.RTYL.23.NM8XV.DaHUG4E1.A97..F.B.QC"
+    "..IK.CXD8.Va7.6.5.PR.YL.....GH2NS.3M"
+    "....A9GJYLP.BT.C.I8N...O.WKS2.1H...."
+    "41.H.U..BCF.S.2...7V..9ZaX..D....G.."
+    ".8..aX..4EHUYGPL....2MWSC..BFQ75AVZ."
+    "BQ.FC.N.O.DXZV.A79.GPLR.....H132M.S."
+    "YJGPLRK3...WO.Da8X16.EU4A9VZ...F.T.I"
+    ".3..MW.7ZA5.4.HE.U.TFC.BLR..P.8DaNOX"
+    "FKCW...VD..O5A..6..LI..P...HRGNX3M.S"
+    "..ER14..FQ..2.X3.S6A.7.58Oa..V.I.L.Y"
+    "PTLIJ.MN..X.Da9.VO.E..4...A.U6K....."
+    "DVa.8...H1R.P.IJ.Y...3.2.BCFWK6U7A.Z"
+    "56A.7ZLTPJIYF.WQK.V..8.D3..2.N.R.EH4"
+    ".N.X..A.5.UZ..R...KCW.BFJ.L.I...8.D.";
+
+static const char* PUZZLE_49 =
+    "In.P..29L...X1fRU.HYh.Te..5.D...B..E..MGW6baiNcAV"
+    "..1.9KkQ6WEM.O..cbiaN.8nP.2I.eC.TlJfYh.dRH.3F.Dm."
+    "FmBZ.4DlC.j.JTKSkXL91.NAba.....fhYd7g82Pn.GQ6OM.."
+    "..hdYfUaiA....je5J...EO.GQ.6kS.K.....BDZ.FPgI8.n7"
+    ".AN.aV...m4D.B7n2PI.8f..dY.....EOQG...5.e...L1k.K"
+    "6WO.QEMYH.f.dh.m...3BK1SX9k..nI7.g.V.NcbA.J.CT5ej"
+    "C.T.lj5gIn.2.8EW..6QO..mZ.DF.A.V..b.9.kX.LdYHhURf"
+    "5JlTCmj....78......6QA.Z.F4..bcRaiNn..K.XkhHUY..."
+    "DZ3BFA4.5J.j.l.XK1.L9Rab.iVcf.UWYHhe.g7...O6.QEG."
+    "...8Ie........Wd.h.HY.lJTC.54ZD.3F..6QE.GMNicaV.R"
+    "MG..6.EH..W..Y.Z4B.F3n9X1.Kk7....I8RiaV.....5.j.."
+    "UdYhH..i...VNamJjT5ClSQG.6EMKX..9L..F34B..8I....."
+    "kX9.Ln.6MG.E...bVNc..egP8.72..5.lC.W.YfhdU.F..4.A"
+    "c..N.RV.D.A.B..P782IgW..hHf.EG.S..Om..j.J..L....."
+    "a4b.Nc...jDFmZ2.I..8PU..R.H...QM.OW5.J..7l.19XL.k"
+    ".K.n8.I1.E..SX.VHRYhd5J7e.ClFj3D.BmMOG6Wf..N.bi.."
+    ".7J..5C..K2I...f6WQOGDZj.B...4acbNA.1XLS..Rh.dH.U"
+    "YVdR.UHNa4ciA...CelT.MGfW.6QLE9k.1...ZFmj3n8gPIK."
+    "...mBD.Tl75CeJkEL.91.cb4A.iaHV....R2.PInKgWOQ.6.M"
+    "9EX.....QfM6.G..iA.Nb.PK..I..7.5JT.U..H.VY.B3ZFjD"
+    ".fG...6hYV..Rd.jF.3...X.S.L.IK..P8ncN.iA..eTlJC.."
+    "fhHY.GWcVN.RaiZ.mlj5...O.MSE.1.PL.9bD.A3B4g27Ie.J"
+    ".N.a.dRD.BbA.....g7.IGH.YUWfSOE...QZ5C.l.j9kKLn.."
+    "78Ig.JekK..n9LGhW....ZC.l5mjAB4..D3XM..QOE.c.iR.."
+    ".1L9k.nME...Q6dNRaV.iJI8g2e7mT.ZC5.GUHW..f3D4..B."
+    "..Cl5Z.2...egIXOSQ.M6bFB3DA.R.VdicaP....1..Uf.W.G"
+    "4.F3.bA5jTZ....1n..kL.iNa.R.WhfG.UYJ2I.g87QM.6.OX"
+    "..6.MX..fhGWY.bB.34D..L.9.nK..7JI2gdc...NVl.jCmT."
+    "..fU.Q.Rd.Yhc...B5Z.j.E6.S1.8....nka...DF.2..7.Il"
+    "JI72..TnPLg.kKQHOUGWf..C..BZN.b.4A.9SE..6.cRdVh.Y"
+    "bF4DA.NmZC3.5jgL.kPn.YVic.h.OH.Q..U.e..2IJMS.E1.."
+    "X6EMS9.W.H.O..aFN..A...Lk..PT.Jl7e2YRV.cid5m.jBC3"
+    "diV.R...b..N.4.IT..e7Qf.U..G..X9ES..m.B.C.kn.K8L."
+    ".C.5..Be.IlT..9...XSEa4FD.NbhidY.RcgnK8..P...f.H."
+    "PLKkng8S.691MEYi.cd..l7..e.J.CZ3j.5.WfOU.G...4NF."
+    "WYU...GVR.hdicBlZ.mj51MQ.E..P9n8...N4..F3.I7.2J.."
+    "m.5Cj...eg.JI21QX.SEMND.F4b...R.c.i8K....n.f.UGYO"
+    "e.2.7.JKn98.L..YGHW..B5lC..mb..ND4F.EM.6QS.VRcd.h"
+    ".9kL..PES.1X6Mh.diR.c.2gI7JeZ.mB5.COfU.H...4ADb3N"
+    "RaciVhd4A3.bF...J.e.2.UYHfG.XQS1M.6B.5ZClm.Kn..9."
+    ".3D..N.jmlBZC589.Ln.khcaiVdRGYWOUfH..2JIge6E..XQ."
+    "SQM6E1..WYOGHUN..F.4D8k9L.P.Jge....hV..i.RCjm.ZlB"
+    "hc.V..Y.N..a4AC2.7TJ.6WU.GQO9.1..X......5B.P8.g.I"
+    "8..KPIg..ML9.SH.YVhdRCe2.JlT3.BFmZ.6GW.f.O..NAa.i"
+    "1M.EXL....6.fWiDa.N.A.n......2..e.7Hd...c.j.B.35."
+    "O...G.Qd..HYVRF53..ZmLS.EX91g...n.K.bA.4D..JT..2."
+    ".2..JClP8kI.K..UQ.O.WFm5..3...Ni.b4.XS.EM1V.h...."
+    "ND.4bi.ZB..3..Ikg..Pn...VdYhQUO...f....7.TEX1S.M."
+    "B5.jZ.3JT2.l7.LM9.1XSiA.4baNYc..R......Kk8f.OWQ..";
+
+static int failures = 0;
+
+// Forward declarations of helper functions
+static void check(bool ok, const char* what);
+static int* load_puzzle(const char* cells, int dim);
+static bool keeps_givens(const int* puzzle, const int* solution, int dim);
+static void test_engines(const int* puzzle, int dim);
+static void test_budget(const int* puzzle, int dim);
+static void test_solve_many(const int* puzzle, int dim);
+
+/**
+ * @brief Check that 36x36 and 49x49 puzzles solve on both engines and through the default paths
+ * @return 0 if every check passed, 1 otherwise
+ */
+int main(void) {
+    int* puzzle_36 = load_puzzle(PUZZLE_36, 36);
+    int* puzzle_49 = load_puzzle(PUZZLE_49, 49);
+    check(puzzle_36 && puzzle_49, "the puzzles load");
+    if (!puzzle_36 || !puzzle_49) return 1;
+
+    test_engines(puzzle_36, 36);
+    test_engines(puzzle_49, 49);
+    test_budget(puzzle_49, 49);
+    test_solve_many(puzzle_36, 36);
+
+    free(puzzle_36);
+    free(puzzle_49);
+    free_matrix_templates();
+
+    if (failures == 0) printf("test_large_grids: all checks passed\n");
+    return failures == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Record and report one check
+ * @param ok Result of the check
+ * @param what Description of what was expected
+ */
+static void check(bool ok, const char* what) {
+    if (ok) return;
+
+    printf("FAIL: %s\n", what);
+    failures++;
+}
+
+/**
+ * @brief Read a puzzle string into a newly allocated board
+ * @param cells dim * dim characters: '.' for empty, 1-9, then A-Z and a-z for 10 onwards
+ * @param dim Dimension of the puzzle
+ * @return Board of dim * dim cells (free with free()), or NULL if out of memory
+ */
+static int* load_puzzle(const char* cells, int dim) {
+    int num_cells = dim * dim;
+    int* puzzle = (int*)malloc(sizeof(int) * num_cells);
+    if (!puzzle) return NULL;
+
+    for (int i = 0; i < num_cells; i++) {
+        char c = cells[i];
+        if (c == '.') puzzle[i] = 0;
+        else if (c <= '9') puzzle[i] = c - '0';
+        else if (c <= 'Z') puzzle[i] = c - 'A' + 10;
+        else puzzle[i] = c - 'a' + 36;
+    }
+    return puzzle;
+}
+
+/**
+ * @brief Check that a solution keeps every given of its puzzle
+ * @param puzzle Puzzle (0 for empty cells)
+ * @param solution Solved board
+ * @param dim Dimension of the puzzle
+ * @return true if every given is in place
+ */
+static bool keeps_givens(const int* puzzle, const int* solution, int dim) {
+    for (int i = 0; i < dim * dim; i++) {
+        if (puzzle[i] != 0 && solution[i] != puzzle[i]) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Solve a puzzle on the pointer engine, the index engine and the default path, and validate each board
+ * @param puzzle Puzzle to solve
+ * @param dim Dimension of the puzzle
+ */
+static void test_engines(const int* puzzle, int dim) {
+    static const solver_engine ENGINES[] = { SOLVER_ENGINE_POINTER, SOLVER_ENGINE_INDEX };
+    int* solution = (int*)malloc(sizeof(int) * dim * dim);
+    if (!solution) return;
+
+    for (int e = 0; e < 2; e++) {
+        memset(solution, 0, sizeof(int) * dim * dim);
+        bool solved = solve_puzzle_with_engine(puzzle, dim, solution, ENGINES[e]);
+        if (!solved || !validate_solution(solution, dim) || !keeps_givens(puzzle, solution, dim)) {
+            printf("FAIL: %dx%d on the %s engine does not give a valid solution\n",
+                   dim, dim, ENGINES[e] == SOLVER_ENGINE_INDEX ? "index" : "pointer");
+            failures++;
+        }
+    }
+
+    // Past 25x25 the default path searches on the index engine; its stats must show the search
+    solve_stats stats;
+    memset(solution, 0, sizeof(int) * dim * dim);
+    search_status status = solve_puzzle_stats(puzzle, dim, solution, 0, &stats);
+    check(status == SEARCH_SOLVED && validate_solution(solution, dim) && keeps_givens(puzzle, solution, dim),
+          "solve_puzzle_stats gives a valid solution");
+    check(stats.search.nodes > 0 && stats.search.covers > 0, "solve_puzzle_stats counts the index search");
+
+    free(solution);
+}
+
+/**
+ * @brief A budget too small to finish gives up, and the puzzle still solves afterwards
+ * @param puzzle Puzzle to solve
+ * @param dim Dimension of the puzzle
+ */
+static void test_budget(const int* puzzle, int dim) {
+    int* solution = (int*)malloc(sizeof(int) * dim * dim);
+    if (!solution) return;
+
+    check(solve_puzzle_budget(puzzle, dim, solution, 10) == SEARCH_BUDGET_EXHAUSTED,
+          "a budget of 10 placements runs out on a 49x49 puzzle");
+    check(solve_puzzle_budget(puzzle, dim, solution, 0) == SEARCH_SOLVED && validate_solution(solution, dim),
+          "the same puzzle solves without a budget");
+
+    // A given clashing with another in its row leaves no solution on either path
+    int* broken = (int*)malloc(sizeof(int) * dim * dim);
+    if (broken) {
+        memcpy(broken, puzzle, sizeof(int) * dim * dim);
+        int a = -1, b = -1;
+        for (int i = 0; i < dim && b < 0; i++) {
+            if (broken[i] == 0) continue;
+            if (a < 0) a = i;
+            else b = i;
+        }
+        check(b >= 0, "the first row has two givens");
+        if (b >= 0) {
+            broken[b] = broken[a];
+            check(solve_puzzle_budget(broken, dim, solution, 0) == SEARCH_UNSAT, "clashing givens are unsolvable");
+            check(!solve_puzzle_with_engine(broken, dim, solution, SOLVER_ENGINE_INDEX),
+                  "clashing givens are unsolvable on the index engine");
+        }
+        free(broken);
+    }
+
+    free(solution);
+}
+
+/**
+ * @brief solve_many solves a batch of large puzzles without templates
+ * @param puzzle Puzzle to copy into every slot of the batch
+ * @param dim Dimension of the puzzle
+ */
+static void test_solve_many(const int* puzzle, int dim) {
+    const int n = 3;
+    size_t num_cells = (size_t)dim * dim;
+    int* puzzles = (int*)malloc(sizeof(int) * num_cells * n);
+    int* solutions = (int*)malloc(sizeof(int) * num_cells * n);
+    search_status status[3];
+    if (!puzzles || !solutions) {
+        free(puzzles);
+        free(solutions);
+        return;
+    }
+
+    for (int i = 0; i < n; i++) {
+        memcpy(puzzles + num_cells * i, puzzle, sizeof(int) * num_cells);
+    }
+
+    check(solve_many(puzzles, n, dim, solutions, status, 2) == n, "solve_many solves every 36x36 puzzle");
+    for (int i = 0; i < n; i++) {
+        check(status[i] == SEARCH_SOLVED && validate_solution(solutions + num_cells * i, dim)
+              && keeps_givens(puzzle, solutions + num_cells * i, dim), "solve_many gives valid solutions");
+    }
+
+    free(puzzles);
+    free(solutions);
+}
@@ -0,0 +1,203 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "dlinks_parallel.h"
+#include "exact_cover.h"
+
+// Most covers collected for comparison (8-queens has 92)
+#define MAX_COVERS 128
+
+/**
+ * @brief Covers reported by an enumeration, each as a bit set of row ids
+ */
+typedef struct {
+    uint64_t covers[MAX_COVERS];
+    int count;
+} cover_list;
+
+static int failures = 0;
+
+// Forward declarations of helper functions
+static void check(bool ok, const char* what);
+static ExactCover* create_queens(int n);
+static bool collect_cover(Node* const* rows, int num_rows, void* data);
+static int compare_covers(const void* a, const void* b);
+static bool same_covers(cover_list* a, cover_list* b);
+static void compare_with_serial(ExactCover* ec, long long expected, const char* name);
+
+/**
+ * @brief Check that parallel search agrees with serial search for 1, 2 and 4 threads
+ * @return 0 if every check passed, 1 otherwise
+ */
+int main(void) {
+    ExactCover* queens = create_queens(8);
+    ExactCover* unsat = create_queens(3);
+    check(queens && unsat, "the N-queens problems build");
+    if (!queens || !unsat) return 1;
+
+    compare_with_serial(queens, 92, "8-queens");
+    compare_with_serial(unsat, 0, "3-queens");
+
+    delete_exact_cover(queens);
+    delete_exact_cover(unsat);
+
+    if (failures == 0) printf("test_parallel: all checks passed\n");
+    return failures == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Record and report one check
+ * @param ok Result of the check
+ * @param what Description of what was expected
+ */
+static void check(bool ok, const char* what) {
+    if (ok) return;
+
+    printf("FAIL: %s\n", what);
+    failures++;
+}
+
+/**
+ * @brief Build N-queens as exact cover, ranks and files primary and diagonals secondary
+ * @param n Board size (at most 8, so row ids fit a 64 bit set)
+ * @return Pointer to the new problem, NULL if out of memory
+ */
+static ExactCover* create_queens(int n) {
+    int num_rows = n * n;
+    int* offsets = (int*)malloc(sizeof(int) * (num_rows + 1));
+    int* columns = (int*)malloc(sizeof(int) * num_rows * 4);
+    if (!offsets || !columns) {
+        free(offsets);
+        free(columns);
+        return NULL;
+    }
+
+    for (int r = 0; r < n; r++) {
+        for (int c = 0; c < n; c++) {
+            int row = r * n + c;
+            offsets[row] = row * 4;
+            columns[row * 4] = r;
+            columns[row * 4 + 1] = n + c;
+            columns[row * 4 + 2] = 2 * n + r + c;
+            columns[row * 4 + 3] = 2 * n + (2 * n - 1) + (r - c + n - 1);
+        }
+    }
+    offsets[num_rows] = num_rows * 4;
+
+    ExactCover* ec = create_exact_cover_xcc(num_rows, 2 * n, 2 * (2 * n - 1), offsets, columns, NULL);
+    free(offsets);
+    free(columns);
+    return ec;
+}
+
+/**
+ * @brief Add a reported cover to a cover_list
+ * @param rows Row nodes of the cover
+ * @param num_rows Number of rows in the cover
+ * @param data Pointer to the cover_list
+ * @return true to keep searching
+ */
+static bool collect_cover(Node* const* rows, int num_rows, void* data) {
+    cover_list* list = (cover_list*)data;
+    if (list->count == MAX_COVERS) return false;
+
+    uint64_t cover = 0;
+    for (int i = 0; i < num_rows; i++) {
+        cover |= (uint64_t)1 << rows[i]->row;
+    }
+    list->covers[list->count++] = cover;
+    return true;
+}
+
+/**
+ * @brief Order covers for qsort
+ * @param a Pointer to the first cover
+ * @param b Pointer to the second cover
+ * @return Negative, zero or positive as a is below, equal to or above b
+ */
+static int compare_covers(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Check whether two enumerations found the same covers, in any order
+ * @param a First list (sorted in place)
+ * @param b Second list (sorted in place)
+ * @return true if both hold the same covers
+ */
+static bool same_covers(cover_list* a, cover_list* b) {
+    if (a->count != b->count) return false;
+
+    qsort(a->covers, a->count, sizeof(uint64_t), compare_covers);
+    qsort(b->covers, b->count, sizeof(uint64_t), compare_covers);
+    for (int i = 0; i < a->count; i++) {
+        if (a->covers[i] != b->covers[i]) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Compare parallel count, enumerate and search with serial search for 1, 2 and 4 threads
+ * @param ec Pointer to the problem
+ * @param expected Known number of covers
+ * @param name Name of the problem, for failure messages
+ */
+static void compare_with_serial(ExactCover* ec, long long expected, const char* name) {
+    static const int THREADS[] = { 1, 2, 4 };
+    static cover_list serial, parallel;
+
+    serial.count = 0;
+    long long serial_count = alg_x_count(ec->matrix, 0);
+    long long serial_reported = alg_x_enumerate(ec->matrix, 0, collect_cover, &serial);
+    if (serial_count != expected || serial_reported != expected) {
+        printf("FAIL: %s: serial search finds %lld covers, not %lld\n", name, serial_count, expected);
+        failures++;
+    }
+
+    for (size_t t = 0; t < sizeof(THREADS) / sizeof(THREADS[0]); t++) {
+        int num_threads = THREADS[t];
+
+        parallel.count = 0;
+        long long counted = parallel_count(ec->matrix, 0, num_threads);
+        long long reported = parallel_enumerate(ec->matrix, 0, collect_cover, &parallel, num_threads);
+        search_status status = parallel_search(ec->matrix, num_threads);
+
+        if (counted != serial_count || reported != serial_count) {
+            printf("FAIL: %s with %d threads: %lld counted and %lld reported, serial finds %lld\n",
+                   name, num_threads, counted, reported, serial_count);
+            failures++;
+        }
+        if (!same_covers(&serial, &parallel)) {
+            printf("FAIL: %s with %d threads: the covers differ from serial search\n", name, num_threads);
+            failures++;
+        }
+        if (status != (serial_count > 0 ? SEARCH_SOLVED : SEARCH_UNSAT)) {
+            printf("FAIL: %s with %d threads: search gives status %d\n", name, num_threads, (int)status);
+            failures++;
+        }
+
+        // The cover parallel_search leaves on the matrix must be one serial search found
+        if (status == SEARCH_SOLVED) {
+            cover_list found = { { 0 }, 0 };
+            solution_stack* stack = ec->matrix->solution;
+            collect_cover((Node* const*)stack->items, stack->count, &found);
+            if (!bsearch(&found.covers[0], serial.covers, serial.count, sizeof(uint64_t), compare_covers)) {
+                printf("FAIL: %s with %d threads: search leaves a cover serial search does not find\n", name, num_threads);
+                failures++;
+            }
+        }
+
+        // Undo the cover like exact_cover_solve does, so the matrix can be searched again
+        while (ec->matrix->solution->count > 0) {
+            pop_row(ec->matrix);
+        }
+        ec->matrix->solved = false;
+
+        if (parallel_count(ec->matrix, 10, num_threads) != (serial_count < 10 ? serial_count : 10)) {
+            printf("FAIL: %s with %d threads: a limit does not cap the count\n", name, num_threads);
+            failures++;
+        }
+    }
+}
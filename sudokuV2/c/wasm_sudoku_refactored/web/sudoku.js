@@ -30,16 +30,27 @@ SudokuModule().then(module => {
     ];
 
     // Create references to WASM exported functions
-    const solveSudoku = module.cwrap('solve_sudoku', 'number', ['number', 'number', 'number']);
+    const solveSudokuBoards = module.cwrap('solve_sudoku_boards', 'number', ['number', 'number', 'number', 'number', 'number']);
+    const allocateSudokuBoards = module.cwrap('allocate_sudoku_boards', 'number', ['number', 'number']);
+    const freeSudokuBoards = module.cwrap('free_sudoku_boards', 'void', ['number']);
     const allocateSudokuArray = module.cwrap('allocate_sudoku_array', 'number', ['number']);
     const freeSudokuArray = module.cwrap('free_sudoku_array', 'number', ['number']);
-    const setSudokuValue = module.cwrap('set_sudoku_value', 'void', ['number', 'number', 'number']);
-    const getSudokuValue = module.cwrap('get_sudoku_value', 'number', ['number', 'number']);
     const validateSudoku = module.cwrap('validate_sudoku', 'number', ['number', 'number']);
     const hasUniqueSolution = module.cwrap('has_unique_sudoku_solution', 'number', ['number', 'number']);
     const getPuzzleDifficulty = module.cwrap('get_sudoku_difficulty', 'number', ['number', 'number']);
     const generateSudoku = module.cwrap('generate_sudoku', 'number', ['number', 'number', 'number']);
 
+    // Copy a board into byte-packed WASM memory in one go
+    // (heap views are taken on every access since memory growth replaces them)
+    function writeBoard(ptr, board) {
+        module.HEAPU8.set(board, ptr);
+    }
+
+    // Copy a byte-packed board out of WASM memory
+    function readBoard(ptr) {
+        return Array.from(module.HEAPU8.subarray(ptr, ptr + DIM * DIM));
+    }
+
     // Initialize the Sudoku grid
     function initializeGrid() {
         sudokuGrid.innerHTML = '';
@@ -90,26 +101,18 @@ SudokuModule().then(module => {
             const puzzle = getPuzzleFromGrid();
 
             // Allocate memory for the puzzle and solution
-            const puzzlePtr = allocateSudokuArray(DIM);
-            const solutionPtr = allocateSudokuArray(DIM);
+            const puzzlePtr = allocateSudokuBoards(DIM, 1);
+            const solutionPtr = allocateSudokuBoards(DIM, 1);
 
             // Copy puzzle data to WASM memory
-            for (let i = 0; i < DIM * DIM; i++) {
-                setSudokuValue(puzzlePtr, i, puzzle[i]);
-            }
+            writeBoard(puzzlePtr, puzzle);
 
             // Solve the puzzle
-            const solved = solveSudoku(puzzlePtr, DIM, solutionPtr);
+            const solved = solveSudokuBoards(puzzlePtr, 1, DIM, solutionPtr, 1) === 1;
 
             if (solved) {
-                // Get solution from WASM memory
-                const solution = new Array(DIM * DIM);
-                for (let i = 0; i < DIM * DIM; i++) {
-                    solution[i] = getSudokuValue(solutionPtr, i);
-                }
-
-                // Update the grid with the solution
-                loadPuzzle(solution);
+                // Update the grid with the solution from WASM memory
+                loadPuzzle(readBoard(solutionPtr));
                 statusElement.textContent = 'Puzzle solved successfully!';
             } else {
                 statusElement.textContent = 'No solution exists for this puzzle.';
@@ -117,8 +120,8 @@ SudokuModule().then(module => {
             }
 
             // Free memory
-            freeSudokuArray(puzzlePtr);
-            freeSudokuArray(solutionPtr);
+            freeSudokuBoards(puzzlePtr);
+            freeSudokuBoards(solutionPtr);
         } catch (error) {
             statusElement.textContent = 'Error: ' + error.message;
             statusElement.className = 'status error';
@@ -159,11 +162,9 @@ SudokuModule().then(module => {
             const success = generateSudoku(puzzlePtr, DIM, difficulty);
 
             if (success) {
-                // Get generated puzzle from WASM memory
-                const puzzle = new Array(DIM * DIM);
-                for (let i = 0; i < DIM * DIM; i++) {
-                    puzzle[i] = getSudokuValue(puzzlePtr, i);
-                }
+                // Get generated puzzle from WASM memory (int cells)
+                const start = puzzlePtr >> 2;
+                const puzzle = Array.from(module.HEAP32.subarray(start, start + DIM * DIM));
 
                 // Update the grid with the generated puzzle
                 loadPuzzle(puzzle);